@@ -0,0 +1,197 @@
+//
+//  ABTestRunner.swift
+//  Basic-Video-Chat
+//
+//  Scripted A/B mode: alternates baseline and QoD windows of fixed length
+//  so every run has the same shape, then pairs them up for comparison.
+//
+
+import Foundation
+
+struct ABTestConfiguration {
+    var baselineDuration: TimeInterval = 60
+    var qodDuration: TimeInterval = 60
+    var repeatCount: Int = 3
+    // Samples from the start of each window are ignored while QoD activates / tears down
+    var settleTime: TimeInterval = 5
+}
+
+protocol ABTestRunnerDelegate: AnyObject {
+    func abTestRunner(_ runner: ABTestRunner, didBegin window: TestWindow)
+    func abTestRunner(_ runner: ABTestRunner, didEnd window: TestWindow)
+    func abTestRunnerDidFinish(_ runner: ABTestRunner)
+}
+
+class ABTestRunner {
+    let configuration: ABTestConfiguration
+    weak var delegate: ABTestRunnerDelegate?
+
+    private(set) var windows: [TestWindow] = []
+    private(set) var isRunning: Bool = false
+    private var windowTimer: Timer?
+
+    init(configuration: ABTestConfiguration) {
+        self.configuration = configuration
+    }
+
+    deinit {
+        windowTimer?.invalidate()
+    }
+
+    var currentWindow: TestWindow? {
+        return isRunning ? windows.last : nil
+    }
+
+    func start() {
+        guard !isRunning, configuration.repeatCount > 0 else { return }
+        isRunning = true
+        windows.removeAll()
+        beginWindow(kind: .baseline, iteration: 0)
+    }
+
+    /// Stops the run early, closing the current window at the current time.
+    func cancel() {
+        guard isRunning else { return }
+        windowTimer?.invalidate()
+        windowTimer = nil
+        endCurrentWindow()
+        isRunning = false
+    }
+
+    private static func now() -> TimeInterval {
+        return Date().timeIntervalSince1970 * 1000
+    }
+
+    private func beginWindow(kind: TestWindow.Kind, iteration: Int) {
+        let window = TestWindow(kind: kind,
+                                iteration: iteration,
+                                startTimestamp: ABTestRunner.now(),
+                                endTimestamp: ABTestRunner.now())
+        windows.append(window)
+        print("A/B test: starting \(window.label)")
+        delegate?.abTestRunner(self, didBegin: window)
+
+        let duration = kind == .baseline ? configuration.baselineDuration : configuration.qodDuration
+        windowTimer = Timer.scheduledTimer(withTimeInterval: duration, repeats: false) { [weak self] _ in
+            self?.advance()
+        }
+    }
+
+    private func endCurrentWindow() {
+        guard !windows.isEmpty else { return }
+        windows[windows.count - 1].endTimestamp = ABTestRunner.now()
+        let window = windows[windows.count - 1]
+        print("A/B test: finished \(window.label)")
+        delegate?.abTestRunner(self, didEnd: window)
+    }
+
+    private func advance() {
+        guard isRunning, let window = windows.last else { return }
+        endCurrentWindow()
+
+        switch window.kind {
+        case .baseline:
+            beginWindow(kind: .qod, iteration: window.iteration)
+        case .qod where window.iteration + 1 < configuration.repeatCount:
+            beginWindow(kind: .baseline, iteration: window.iteration + 1)
+        case .qod:
+            windowTimer = nil
+            isRunning = false
+            delegate?.abTestRunnerDidFinish(self)
+        }
+    }
+}
+
+// MARK: - Paired comparison
+
+/// Per-metric paired comparison of QoD windows against the baseline window
+/// that precedes them.
+struct PairedComparison {
+    struct Pair {
+        let iteration: Int
+        let baseline: Double
+        let qod: Double
+
+        var delta: Double { return qod - baseline }
+    }
+
+    let metric: String
+    let pairs: [Pair]
+
+    var meanDelta: Double {
+        guard !pairs.isEmpty else { return 0 }
+        return pairs.reduce(0) { $0 + $1.delta } / Double(pairs.count)
+    }
+
+    var standardDeviation: Double {
+        guard pairs.count > 1 else { return 0 }
+        let mean = meanDelta
+        let sumOfSquares = pairs.reduce(0) { $0 + ($1.delta - mean) * ($1.delta - mean) }
+        return (sumOfSquares / Double(pairs.count - 1)).squareRoot()
+    }
+
+    /// Paired t statistic with `pairs.count - 1` degrees of freedom, nil when undefined.
+    var tStatistic: Double? {
+        let sd = standardDeviation
+        guard pairs.count > 1, sd > 0 else { return nil }
+        return meanDelta / (sd / Double(pairs.count).squareRoot())
+    }
+
+    var summary: String {
+        var text = "\(metric): mean Δ \(String(format: "%+.3f", meanDelta)) over \(pairs.count) pair(s)"
+        if let t = tStatistic {
+            text += ", t(\(pairs.count - 1)) = \(String(format: "%.2f", t))"
+        }
+        return text
+    }
+
+    /// Bitrate and packet loss, then every frame-quality metric measured in at least one pair.
+    static func compare(_ result: VideoResultSet, settleTime: TimeInterval) -> [PairedComparison] {
+        let settleMs = settleTime * 1000
+
+        // Samples of either kind are recorded in time order with millisecond timestamps
+        func mean<Sample>(of window: TestWindow, in samples: [Sample],
+                          timestamp: (Sample) -> TimeInterval, value: (Sample) -> Double?) -> Double? {
+            let from = window.startTimestamp + settleMs
+            var sum = 0.0
+            var count = 0
+            for sample in samples where timestamp(sample) >= from && timestamp(sample) < window.endTimestamp {
+                guard let sampleValue = value(sample) else { continue }
+                sum += sampleValue
+                count += 1
+            }
+            return count > 0 ? sum / Double(count) : nil
+        }
+
+        func pairs<Sample>(_ samples: [Sample], timestamp: (Sample) -> TimeInterval,
+                           value: (Sample) -> Double?) -> [Pair] {
+            var baselines: [Int: Double] = [:]
+            var matched: [Pair] = []
+            for window in result.windows {
+                guard let m = mean(of: window, in: samples, timestamp: timestamp, value: value) else { continue }
+                switch window.kind {
+                case .baseline:
+                    baselines[window.iteration] = m
+                case .qod:
+                    if let baseline = baselines[window.iteration] {
+                        matched.append(Pair(iteration: window.iteration, baseline: baseline, qod: m))
+                    }
+                }
+            }
+            return matched
+        }
+
+        let stats = result.qualityStats
+        let ticks = result.frameQualityTicks
+        let frameQuality = FrameQualityMetric.allCases.compactMap { metric -> PairedComparison? in
+            let matched = pairs(ticks, timestamp: { $0.timestamp }, value: { $0.value(of: metric) })
+            return matched.isEmpty ? nil : PairedComparison(metric: metric.title, pairs: matched)
+        }
+        return [
+            PairedComparison(metric: "Bitrate (Kbps)", pairs: pairs(stats, timestamp: { $0.timestamp },
+                                                                    value: { $0.videoBitrateKbps })),
+            PairedComparison(metric: "Packet loss", pairs: pairs(stats, timestamp: { $0.timestamp },
+                                                                 value: { $0.packetLossRatio }))
+        ] + frameQuality
+    }
+}
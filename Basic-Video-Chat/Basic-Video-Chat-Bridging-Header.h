@@ -0,0 +1,8 @@
+//
+//  Basic-Video-Chat-Bridging-Header.h
+//  Basic-Video-Chat
+//
+//  C declarations visible to the app's Swift code.
+//
+
+#import "PlaneBufferAtomics.h"
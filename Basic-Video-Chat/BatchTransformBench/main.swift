@@ -0,0 +1,63 @@
+//
+//  main.swift
+//  BatchTransformBench
+//
+//  Per-frame cost of mapping a series to pixels: DGCharts' per-point
+//  pointValuesToPixel against Transformer.pixelPoints from
+//  Transformer+BatchTransform.swift, at 10k, 100k and 1M points. Needs the
+//  DGCharts module, so it builds on macOS only (see "Benchmarks" in the
+//  README):
+//
+//    swiftc -O -I .bench -L .bench -lDGCharts Basic-Video-Chat/BenchSupport/BenchSupport.swift \
+//        Basic-Video-Chat/Transformer+BatchTransform.swift Basic-Video-Chat/BatchTransformBench/main.swift \
+//        -o batch-transform-bench
+//    DYLD_LIBRARY_PATH=.bench ./batch-transform-bench
+//
+//  Both sides reuse their output array across frames, as the renderer does,
+//  so the numbers are the transform alone.
+//
+
+import Foundation
+import CoreGraphics
+import DGCharts
+
+let phaseY = 0.8
+
+for pointCount in [10_000, 100_000, 1_000_000] {
+    var random = BenchRandom()
+    let samples = random.series(count: pointCount)
+
+    let viewPortHandler = ViewPortHandler(width: 1000, height: 400)
+    let transformer = Transformer(viewPortHandler: viewPortHandler)
+    transformer.prepareMatrixValuePx(chartXMin: samples.x[0],
+                                     deltaX: CGFloat(samples.x[pointCount - 1] - samples.x[0]),
+                                     deltaY: CGFloat((samples.y.max() ?? 1) - (samples.y.min() ?? 0)),
+                                     chartYMin: samples.y.min() ?? 0)
+    transformer.prepareMatrixOffset(inverted: false)
+
+    print("\(pointCount) points")
+
+    var stockPoints = [CGPoint](repeating: .zero, count: pointCount)
+    let stock = Bench.measure {
+        for i in 0 ..< pointCount {
+            stockPoints[i] = CGPoint(x: samples.x[i], y: samples.y[i] * phaseY)
+        }
+        transformer.pointValuesToPixel(&stockPoints)
+    }
+    Bench.report("  pointValuesToPixel", stock,
+                 extra: Bench.format(seconds: stock.median / Double(pointCount)) + " per point")
+
+    var batchPoints: [CGPoint] = []
+    let batch = Bench.measure {
+        transformer.pixelPoints(xValues: samples.x[...], yValues: samples.y[...], range: 0 ..< pointCount,
+                                phaseY: phaseY, into: &batchPoints)
+    }
+    Bench.report("  pixelPoints", batch,
+                 extra: Bench.format(seconds: batch.median / Double(pointCount)) + " per point")
+
+    // Same matrix, same points: the batch path must agree with DGCharts to rounding
+    let worst = zip(stockPoints, batchPoints).reduce(CGFloat(0)) {
+        max($0, abs($1.0.x - $1.1.x), abs($1.0.y - $1.1.y))
+    }
+    print(String(format: "  largest difference %.2e px", Double(worst)))
+}
@@ -0,0 +1,115 @@
+//
+//  BenchSupport.swift
+//  Basic-Video-Chat
+//
+//  Timing helpers shared by the command line benchmarks next to this folder.
+//  They are compiled together with the app sources under test and a bench's
+//  main.swift, never into the app. See "Benchmarks" in the README.
+//
+
+import Foundation
+
+enum Bench {
+    /// Command line argument `index` as an Int, or `fallback`.
+    static func argument(_ index: Int, default fallback: Int) -> Int {
+        let arguments = CommandLine.arguments
+        return index < arguments.count ? Int(arguments[index]) ?? fallback : fallback
+    }
+
+    /// Seconds per run of `body`: the fastest and the median of `runs`, after one warm-up run.
+    static func measure(runs: Int = 10, _ body: () -> Void) -> (best: Double, median: Double) {
+        body()
+        var times: [Double] = []
+        times.reserveCapacity(runs)
+        for _ in 0 ..< max(1, runs) {
+            let start = DispatchTime.now().uptimeNanoseconds
+            body()
+            times.append(Double(DispatchTime.now().uptimeNanoseconds - start) / 1e9)
+        }
+        times.sort()
+        return (times[0], times[times.count / 2])
+    }
+
+    /// One result line: the name, then best and median per run in a fitting unit.
+    static func report(_ name: String, _ time: (best: Double, median: Double), extra: String = "") {
+        let line = name.padding(toLength: 44, withPad: " ", startingAt: 0)
+            + "best " + format(seconds: time.best) + "  median " + format(seconds: time.median)
+        print(extra.isEmpty ? line : line + "  " + extra)
+    }
+
+    static func format(seconds: Double) -> String {
+        switch seconds {
+        case ..<1e-6: return String(format: "%7.1f ns", seconds * 1e9)
+        case ..<1e-3: return String(format: "%7.2f us", seconds * 1e6)
+        case ..<1: return String(format: "%7.2f ms", seconds * 1e3)
+        default: return String(format: "%7.2f s ", seconds)
+        }
+    }
+
+    static func format(bytes: Int) -> String {
+        let value = Double(bytes)
+        switch value {
+        case ..<1024: return "\(bytes) B"
+        case ..<(1024 * 1024): return String(format: "%.1f KB", value / 1024)
+        default: return String(format: "%.1f MB", value / (1024 * 1024))
+        }
+    }
+
+    /// Resident memory of this process, for before and after comparisons.
+    static func residentBytes() -> Int {
+        #if canImport(Darwin)
+        var info = mach_task_basic_info()
+        var count = mach_msg_type_number_t(MemoryLayout<mach_task_basic_info>.size / MemoryLayout<natural_t>.size)
+        let result = withUnsafeMutablePointer(to: &info) {
+            $0.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+                task_info(mach_task_self_, task_flavor_t(MACH_TASK_BASIC_INFO), $0, &count)
+            }
+        }
+        return result == KERN_SUCCESS ? Int(info.resident_size) : 0
+        #else
+        // Second field of statm is the resident page count
+        guard let statm = try? String(contentsOfFile: "/proc/self/statm", encoding: .utf8) else { return 0 }
+        let fields = statm.split(separator: " ")
+        return fields.count > 1 ? (Int(fields[1]) ?? 0) * Int(sysconf(Int32(_SC_PAGESIZE))) : 0
+        #endif
+    }
+
+    /// Keeps the optimizer from dropping work whose result is otherwise unused.
+    @inline(never)
+    static func consume<T>(_ value: T) {
+        withExtendedLifetime(value) {}
+    }
+}
+
+/// SplitMix64, so every run of a bench sees the same data.
+struct BenchRandom: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64 = 0x9E37_79B9_7F4A_7C15) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E37_79B9_7F4A_7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58_476D_1CE4_E5B9
+        z = (z ^ (z >> 27)) &* 0x94D0_49BB_1331_11EB
+        return z ^ (z >> 31)
+    }
+}
+
+extension BenchRandom {
+    /// A bitrate-like random walk: `count` samples 0.5 s apart, with a NaN gap every `gapEvery`.
+    mutating func series(count: Int, gapEvery: Int = 0) -> (x: [Double], y: [Double]) {
+        var x = [Double](), y = [Double]()
+        x.reserveCapacity(count)
+        y.reserveCapacity(count)
+        var value = 1500.0
+        for index in 0 ..< count {
+            value = max(0, value + Double.random(in: -60 ... 60, using: &self))
+            x.append(Double(index) * 0.5)
+            y.append(gapEvery > 0 && index % gapEvery == gapEvery - 1 ? .nan : value)
+        }
+        return (x, y)
+    }
+}
@@ -0,0 +1,18 @@
+//
+//  CaptureStampTransformer.swift
+//  Basic-Video-Chat
+//
+//  Custom video transformer that writes a FrameStamp with the current time
+//  into camera frames, so subscribers can measure glass-to-glass latency
+//  without a custom capturer. The pixels are left untouched.
+//
+
+import Foundation
+import OpenTok
+
+final class CaptureStampTransformer: NSObject, OTCustomVideoTransformer {
+    func transform(_ frame: OTVideoFrame) {
+        var error: OTError?
+        frame.setMetadata(FrameStamp(captureTime: Date().timeIntervalSince1970).encoded(), error: &error)
+    }
+}
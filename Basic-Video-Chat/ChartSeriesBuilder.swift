@@ -0,0 +1,75 @@
+//
+//  ChartSeriesBuilder.swift
+//  Basic-Video-Chat
+//
+//  Routes each sample into the bitrate and packet loss series for its QoD
+//  state in a single pass, and each frame-quality tick into its metrics'
+//  series the same way. When the state flips, the series being resumed
+//  gets a gap so its line and fill aren't drawn across the other state.
+//
+
+import Foundation
+
+final class ChartSeriesBuilder {
+    private(set) var pyramids: [ChartSeries: SeriesPyramid] = [:]
+    private var lastQoDEnabled: Bool?
+
+    init() {
+        ChartSeries.allCases.forEach { pyramids[$0] = SeriesPyramid() }
+    }
+
+    func append(_ stats: VideoStats) {
+        let bitrate = pyramids[.bitrate(qodEnabled: stats.qodEnabled)]!
+        let packetLoss = pyramids[.packetLoss(qodEnabled: stats.qodEnabled)]!
+
+        if let last = lastQoDEnabled, last != stats.qodEnabled {
+            bitrate.appendGap()
+            packetLoss.appendGap()
+        }
+        lastQoDEnabled = stats.qodEnabled
+
+        let x = stats.timestamp / 1000
+        bitrate.append(x: x, y: stats.videoBitrateKbps)
+        packetLoss.append(x: x, y: stats.packetLossRatio)
+    }
+}
+
+final class FrameQualitySeriesBuilder {
+    private(set) var pyramids: [FrameQualitySeries: SeriesPyramid] = [:]
+    private var lastQoDEnabled: Bool?
+
+    init() {
+        for metric in FrameQualityMetric.allCases {
+            pyramids[FrameQualitySeries(metric: metric, qodEnabled: false)] = SeriesPyramid()
+            pyramids[FrameQualitySeries(metric: metric, qodEnabled: true)] = SeriesPyramid()
+        }
+    }
+
+    func append(_ tick: FrameQualityTick) {
+        let flipped = lastQoDEnabled.map { $0 != tick.qodEnabled } ?? false
+        lastQoDEnabled = tick.qodEnabled
+
+        let x = tick.timestamp / 1000
+        for metric in FrameQualityMetric.allCases {
+            let pyramid = pyramids[FrameQualitySeries(metric: metric, qodEnabled: tick.qodEnabled)]!
+            if flipped {
+                pyramid.appendGap()
+            }
+            // A metric nobody measured this tick leaves no point, the line joins its neighbours
+            if let value = tick.value(of: metric) {
+                pyramid.append(x: x, y: value)
+            }
+        }
+    }
+}
+
+/// Per-sample console output, off by default since formatting every sample dominates long runs.
+/// Messages are only built when logging is enabled.
+enum SampleLog {
+    static var isEnabled = false
+
+    static func print(_ message: @autoclosure () -> String) {
+        guard isEnabled else { return }
+        Swift.print(message())
+    }
+}
@@ -0,0 +1,65 @@
+//
+//  ChartSeriesSource.swift
+//  Basic-Video-Chat
+//
+//  Read side of a chart series that doesn't have to fit in memory. Charts
+//  ask a source for the visible x range at the resolution they can show and
+//  only ever hold that window; see StreamingLineChartDataSet.
+//
+
+import Foundation
+
+protocol ChartSeriesSource: AnyObject {
+    /// x extent of the whole series, nil when it is empty
+    var xRange: ClosedRange<Double>? { get }
+
+    /// Lowest and highest y over `[fromX, toX]`, nil when there is nothing there.
+    /// May include values from just outside the range when the source only keeps summaries.
+    func yBounds(fromX: Double, toX: Double) -> (min: Double, max: Double)?
+
+    /// Points tracing `[fromX, toX]` with about `maxPoints` vertices, sorted by x and extended
+    /// by one point past each end. Raw samples when they fit, otherwise min/max envelopes.
+    /// A NaN y separates segments that must not be joined.
+    func points(fromX: Double, toX: Double, maxPoints: Int) -> (x: [Double], y: [Double])
+}
+
+extension SeriesPyramid: ChartSeriesSource {
+    var xRange: ClosedRange<Double>? {
+        guard let xMin = xMin, let xMax = xMax else { return nil }
+        return xMin ... xMax
+    }
+
+    func yBounds(fromX: Double, toX: Double) -> (min: Double, max: Double)? {
+        // A few coarse buckets are enough for axis bounds
+        let (_, buckets) = query(fromX: fromX, toX: toX, maxBuckets: 64)
+        guard !buckets.isEmpty else { return nil }
+        return buckets.reduce((Double.greatestFiniteMagnitude, -Double.greatestFiniteMagnitude)) {
+            (min($0.0, $1.minY), max($0.1, $1.maxY))
+        }
+    }
+
+    func points(fromX: Double, toX: Double, maxPoints: Int) -> (x: [Double], y: [Double]) {
+        let points = envelope(fromX: fromX, toX: toX, maxPoints: maxPoints)
+        return (points.map { $0.x }, points.map { $0.y })
+    }
+}
+
+extension SeriesBucket {
+    /// Appends this bucket's envelope: its single sample, or its min and max in x order.
+    func appendEnvelope(x: inout [Double], y: inout [Double]) {
+        if count == 1 || minX == maxX {
+            x.append(minX)
+            y.append(minY)
+        } else if minX < maxX {
+            x.append(minX)
+            y.append(minY)
+            x.append(maxX)
+            y.append(maxY)
+        } else {
+            x.append(maxX)
+            y.append(maxY)
+            x.append(minX)
+            y.append(minY)
+        }
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  ClockOffsetEstimator.swift
+//  Basic-Video-Chat
+//
+//  Estimates how far a remote client's wall clock is from ours, NTP style:
+//  we send our time t0, the remote answers with its time t1, and we note
+//  the arrival time t2. Assuming both legs take equally long, the remote
+//  clock is ahead by t1 - (t0 + t2) / 2, give or take half the round trip.
+//  Session signals are relayed by the server, so round trips are long and
+//  noisy; of the last few exchanges the one with the shortest round trip
+//  bounds the error best and is the one used.
+//
+
+import Foundation
+
+struct ClockOffsetEstimator {
+    /// Exchanges kept to pick the best one from
+    let capacity: Int
+    private var samples: [(offset: TimeInterval, roundTrip: TimeInterval)] = []
+
+    init(capacity: Int = 8) {
+        self.capacity = max(1, capacity)
+    }
+
+    mutating func add(sentAt t0: TimeInterval, remoteTime t1: TimeInterval, receivedAt t2: TimeInterval) {
+        guard t2 >= t0 else { return }
+        samples.append((t1 - (t0 + t2) / 2, t2 - t0))
+        if samples.count > capacity {
+            samples.removeFirst()
+        }
+    }
+
+    private var best: (offset: TimeInterval, roundTrip: TimeInterval)? {
+        return samples.min { $0.roundTrip < $1.roundTrip }
+    }
+
+    /// Remote clock minus ours in seconds, nil before the first exchange
+    var offset: TimeInterval? { return best?.offset }
+
+    /// Worst-case error of `offset`, half the best round trip
+    var uncertainty: TimeInterval? { return best.map { $0.roundTrip / 2 } }
+}
+
+/// The two signal messages of a clock exchange. Times are wall-clock seconds since 1970.
+enum ClockSyncMessage {
+    case ping(sentAt: TimeInterval)
+    case pong(sentAt: TimeInterval, remoteTime: TimeInterval)
+
+    static let pingType = "qod-clock-ping"
+    static let pongType = "qod-clock-pong"
+
+    init?(type: String?, string: String?) {
+        let times = (string ?? "").split(separator: ",").compactMap { TimeInterval($0) }
+        switch type {
+        case ClockSyncMessage.pingType? where times.count == 1:
+            self = .ping(sentAt: times[0])
+        case ClockSyncMessage.pongType? where times.count == 2:
+            self = .pong(sentAt: times[0], remoteTime: times[1])
+        default:
+            return nil
+        }
+    }
+
+    var type: String {
+        switch self {
+        case .ping: return ClockSyncMessage.pingType
+        case .pong: return ClockSyncMessage.pongType
+        }
+    }
+
+    var string: String {
+        switch self {
+        case let .ping(sentAt): return String(format: "%.6f", sentAt)
+        case let .pong(sentAt, remoteTime): return String(format: "%.6f,%.6f", sentAt, remoteTime)
+        }
+    }
+}
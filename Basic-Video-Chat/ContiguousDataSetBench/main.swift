@@ -0,0 +1,84 @@
+//
+//  main.swift
+//  ContiguousDataSetBench
+//
+//  Memory and per-frame cost of ContiguousLineChartDataSet against the stock
+//  LineChartDataSet at 100k points. Needs the DGCharts module, so it builds on
+//  macOS only (see "Benchmarks" in the README):
+//
+//    swiftc -O -I .bench -L .bench -lDGCharts Basic-Video-Chat/BenchSupport/BenchSupport.swift \
+//        Basic-Video-Chat/ContiguousLineChartDataSet.swift Basic-Video-Chat/SlidingMinMax.swift \
+//        Basic-Video-Chat/XLookupTable.swift Basic-Video-Chat/ContiguousDataSetBench/main.swift \
+//        -o contiguous-data-set-bench
+//    DYLD_LIBRARY_PATH=.bench ./contiguous-data-set-bench [points] [frames]
+//
+//  A frame is what the live chart does per sample: append one point, drop
+//  the oldest, autoscale y to the visible window and look up the indices to
+//  draw.
+//
+
+import Foundation
+import DGCharts
+
+let pointCount = Bench.argument(1, default: 100_000)
+let frameCount = Bench.argument(2, default: 1000)
+// The live chart shows the last 1000 s, 2000 samples
+let visibleWidth = 1000.0
+
+var random = BenchRandom()
+let samples = random.series(count: pointCount + frameCount * 11)
+print("\(pointCount) points, \(frameCount) frames, \(Int(visibleWidth)) s visible")
+
+// MARK: - Memory
+
+func measureMemory<T>(_ name: String, _ make: () -> T) -> T {
+    let before = Bench.residentBytes()
+    let dataSet = make()
+    let grown = Bench.residentBytes() - before
+    print(name.padding(toLength: 44, withPad: " ", startingAt: 0)
+        + "\(Bench.format(bytes: grown)) resident, \(grown / pointCount) B per point")
+    return dataSet
+}
+
+let contiguous = measureMemory("ContiguousLineChartDataSet") { () -> ContiguousLineChartDataSet in
+    let dataSet = ContiguousLineChartDataSet(entries: [], label: "contiguous")
+    dataSet.replaceValues(x: Array(samples.x[0 ..< pointCount]), y: Array(samples.y[0 ..< pointCount]))
+    return dataSet
+}
+let stock = measureMemory("LineChartDataSet") { () -> LineChartDataSet in
+    let entries = (0 ..< pointCount).map { ChartDataEntry(x: samples.x[$0], y: samples.y[$0]) }
+    return LineChartDataSet(entries: entries, label: "stock")
+}
+
+// MARK: - Per frame
+
+// Every run slides the window on by `frameCount` new samples, the warm-up run included
+var next = pointCount
+
+let contiguousFrames = Bench.measure {
+    for _ in 0 ..< frameCount {
+        let x = samples.x[next]
+        contiguous.append(x: x, y: samples.y[next])
+        contiguous.removeFirst(count: 1)
+        contiguous.calcMinMaxY(fromX: x - visibleWidth, toX: x)
+        Bench.consume(contiguous.visibleIndexRange(fromX: x - visibleWidth, toX: x))
+        next += 1
+    }
+}
+Bench.report("ContiguousLineChartDataSet frame",
+             (contiguousFrames.best / Double(frameCount), contiguousFrames.median / Double(frameCount)))
+
+next = pointCount
+let stockFrames = Bench.measure {
+    for _ in 0 ..< frameCount {
+        let x = samples.x[next]
+        stock.append(ChartDataEntry(x: x, y: samples.y[next]))
+        let _: ChartDataEntry = stock.removeFirst()
+        stock.calcMinMaxY(fromX: x - visibleWidth, toX: x)
+        Bench.consume(stock.entryIndex(x: x - visibleWidth, closestToY: .nan, rounding: .down))
+        Bench.consume(stock.entryIndex(x: x, closestToY: .nan, rounding: .up))
+        next += 1
+    }
+}
+Bench.report("LineChartDataSet frame",
+             (stockFrames.best / Double(frameCount), stockFrames.median / Double(frameCount)))
@@ -0,0 +1,308 @@
+//
+//  ContiguousLineChartDataSet.swift
+//  Basic-Video-Chat
+//
+//  LineChartDataSet backed by two contiguous Double buffers instead of one
+//  ChartDataEntry object per point. ContiguousLineChartRenderer reads the
+//  buffers directly; everything else in DGCharts goes through the usual
+//  accessors, which synthesize entries on demand.
+//
+//  A NaN y value is a gap marker: the renderer lifts the pen there and
+//  closes the fill, so one data set can hold several disjoint segments.
+//
+//  Bounds are kept up to date on every append and front removal instead of
+//  being recomputed by calcMinMax(), so live charts that slide a window or
+//  autoscale to the visible range don't walk every point each frame.
+//
+
+import Foundation
+import DGCharts
+
+class ContiguousLineChartDataSet: LineChartDataSet {
+    // Points before `head` were removed from the front and are dropped in batches
+    private var xStorage: [Double] = []
+    private var yStorage: [Double] = []
+    private var head = 0
+
+    private var windowBounds = MonotonicMinMax()
+    private var rangeTree = MinMaxSegmentTree()
+    // Set by calcMinMaxY(fromX:toX:) for autoscaling, until the next calcMinMax() or mutation
+    private var rangeBounds: (min: Double, max: Double)?
+
+    /// Narrow x lookups (highlighting, visible range) with a bucket table. Pays off for long,
+    /// evenly sampled series; otherwise lookups are a plain binary search.
+    var isLookupTableEnabled = false {
+        didSet { lookupTable.invalidate() }
+    }
+    private var lookupTable = XLookupTable()
+
+    /// Bumped on every change to the points, for renderers caching geometry
+    private(set) var version = 0
+    /// Last version at which points were changed other than by appending or front removal
+    private(set) var rewriteVersion = 0
+    /// Points dropped by removeFirst(count:) so far. `removedCount + i` names point `i` for as
+    /// long as `rewriteVersion` stays the same, however many points go in front of it.
+    private(set) var removedCount = 0
+
+    // Views of the kept points; like any ArraySlice they are indexed from `startIndex`, not 0
+    var xValues: ArraySlice<Double> { return xStorage[head...] }
+    var yValues: ArraySlice<Double> { return yStorage[head...] }
+
+    required init() {
+        super.init()
+    }
+
+    override init(entries: [ChartDataEntry], label: String) {
+        super.init(entries: [], label: label)
+        replaceValues(x: entries.map { $0.x }, y: entries.map { $0.y })
+    }
+
+    // MARK: - Buffer access
+
+    /// Replaces all points in O(n). `x` must be sorted ascending and the same length as `y`.
+    func replaceValues(x: [Double], y: [Double]) {
+        precondition(x.count == y.count, "x and y buffers must have the same length")
+        xStorage = x
+        yStorage = y
+        head = 0
+        rebuildBounds()
+    }
+
+    func reserveCapacity(_ capacity: Int) {
+        xStorage.reserveCapacity(capacity)
+        yStorage.reserveCapacity(capacity)
+    }
+
+    /// Appends a point in amortized O(log n), `x` must not be lower than the last one.
+    func append(x: Double, y: Double) {
+        windowBounds.append(index: yStorage.count, value: y)
+        rangeTree.append(y)
+        xStorage.append(x)
+        yStorage.append(y)
+        rangeBounds = nil
+        version += 1
+    }
+
+    func appendGap() {
+        guard let lastX = xValues.last else { return }
+        append(x: lastX, y: .nan)
+    }
+
+    /// Drops the oldest `count` points in amortized O(1).
+    func removeFirst(count: Int) {
+        precondition(count <= entryCount, "can't remove more points than the data set holds")
+        head += count
+        removedCount += count
+        windowBounds.removeAll(below: head)
+        rangeBounds = nil
+        version += 1
+
+        // Reclaim the removed prefix once it outweighs what is kept
+        if head > 1024 && head * 2 > xStorage.count {
+            xStorage.removeFirst(head)
+            yStorage.removeFirst(head)
+            windowBounds.shiftIndices(by: head)
+            rangeTree.rebuild(yStorage)
+            lookupTable.invalidate()
+            head = 0
+        }
+    }
+
+    func removeAllValues(keepingCapacity: Bool = false) {
+        xStorage.removeAll(keepingCapacity: keepingCapacity)
+        yStorage.removeAll(keepingCapacity: keepingCapacity)
+        head = 0
+        rebuildBounds()
+    }
+
+    private func rebuildBounds() {
+        windowBounds.removeAll()
+        for index in head ..< yStorage.count {
+            windowBounds.append(index: index, value: yStorage[index])
+        }
+        rangeTree.rebuild(yStorage)
+        lookupTable.invalidate()
+        rangeBounds = nil
+        markRewritten()
+    }
+
+    // Existing points change, so cached geometry can't just be extended or trimmed
+    private func markRewritten() {
+        version += 1
+        rewriteVersion = version
+    }
+
+    /// Callers that changed the data set through DGCharts APIs invalidate cached geometry too.
+    override func notifyDataSetChanged() {
+        markRewritten()
+        super.notifyDataSetChanged()
+    }
+
+    /// First index with `x >= value`, or `entryCount`. O(log n), about O(1) through the lookup table.
+    func lowerBound(x value: Double) -> Int {
+        var low = 0
+        var high = xStorage.count
+        if isLookupTableEnabled {
+            // Appends aren't covered until the next rebuild; keep the uncovered tail short
+            if lookupTable.coveredCount * 2 < xStorage.count {
+                lookupTable.rebuild(xStorage)
+            }
+            if let candidates = lookupTable.candidates(for: value) {
+                low = candidates.lowerBound
+                high = candidates.upperBound
+            } else {
+                low = lookupTable.coveredCount
+            }
+        }
+        // Search all of storage so table ranges stay valid, then skip the removed prefix
+        low = Swift.max(low, head)
+        high = Swift.max(high, low)
+        while low < high {
+            let mid = (low + high) / 2
+            if xStorage[mid] < value { low = mid + 1 } else { high = mid }
+        }
+        return low - head
+    }
+
+    /// Indices to draw for `[fromX, toX]`, widened by one point on each side so lines leave the
+    /// viewport instead of stopping at its edge. `phaseX` trims the tail like DGCharts' XBounds.
+    func visibleIndexRange(fromX: Double, toX: Double, phaseX: Double = 1) -> Range<Int> {
+        guard entryCount > 0 else { return 0 ..< 0 }
+        let lower = Swift.max(lowerBound(x: fromX) - 1, 0)
+        let upper = Swift.min(lowerBound(x: toX) + 1, entryCount)
+        let length = Int(Double(upper - lower) * Swift.max(0, Swift.min(1, phaseX)))
+        return lower ..< lower + length
+    }
+
+    // MARK: - Min / max
+
+    // x is sorted and gap markers share the x of a neighbouring point, so x bounds are the ends
+    override var xMin: Double { return xStorage.count > head ? xStorage[head] : Double.greatestFiniteMagnitude }
+    override var xMax: Double { return xStorage.last ?? -Double.greatestFiniteMagnitude }
+    override var yMin: Double { return rangeBounds?.min ?? windowBounds.min ?? Double.greatestFiniteMagnitude }
+    override var yMax: Double { return rangeBounds?.max ?? windowBounds.max ?? -Double.greatestFiniteMagnitude }
+
+    /// Bounds are maintained incrementally, this only ends a visible-range override.
+    override func calcMinMax() {
+        rangeBounds = nil
+    }
+
+    /// O(log n) range query, so autoscaling charts stay cheap at any length.
+    override func calcMinMaxY(fromX: Double, toX: Double) {
+        let from = lowerBound(x: fromX)
+        let to = Swift.min(lowerBound(x: toX) + 1, entryCount)
+        rangeBounds = rangeTree.bounds(in: head + from ..< head + Swift.max(from, to))
+            ?? (Double.greatestFiniteMagnitude, -Double.greatestFiniteMagnitude)
+    }
+
+    // MARK: - Entry accessors for the rest of DGCharts
+
+    override var entryCount: Int { return xStorage.count - head }
+
+    override func entryForIndex(_ i: Int) -> ChartDataEntry? {
+        guard i >= 0, i < entryCount else { return nil }
+        return ChartDataEntry(x: xStorage[head + i], y: yStorage[head + i])
+    }
+
+    override func entryIndex(x xValue: Double, closestToY yValue: Double, rounding: ChartDataSetRounding) -> Int {
+        guard entryCount > 0 else { return -1 }
+
+        var closest = lowerBound(x: xValue)
+        if closest == entryCount {
+            closest -= 1
+        }
+
+        switch rounding {
+        case .up:
+            if xStorage[head + closest] < xValue && closest < entryCount - 1 {
+                closest += 1
+            }
+        case .down:
+            if xStorage[head + closest] > xValue && closest > 0 {
+                closest -= 1
+            }
+        case .closest:
+            if closest > 0 && abs(xStorage[head + closest - 1] - xValue) < abs(xStorage[head + closest] - xValue) {
+                closest -= 1
+            }
+        }
+
+        // Among equal x values prefer the one closest to yValue, never a gap marker
+        let closestX = xStorage[head + closest]
+        var first = closest
+        while first > 0 && xStorage[head + first - 1] == closestX {
+            first -= 1
+        }
+        var best = -1
+        var index = first
+        while index < entryCount && xStorage[head + index] == closestX {
+            let y = yStorage[head + index]
+            if !y.isNaN && (best == -1 || (!yValue.isNaN && abs(y - yValue) < abs(yStorage[head + best] - yValue))) {
+                best = index
+            }
+            index += 1
+        }
+        return best
+    }
+
+    override func entryIndex(entry e: ChartDataEntry) -> Int {
+        let index = lowerBound(x: e.x)
+        guard index < entryCount, xStorage[head + index] == e.x else { return -1 }
+        return entryIndex(x: e.x, closestToY: e.y, rounding: .closest)
+    }
+
+    override func entryForXValue(_ xValue: Double, closestToY yValue: Double, rounding: ChartDataSetRounding) -> ChartDataEntry? {
+        return entryForIndex(entryIndex(x: xValue, closestToY: yValue, rounding: rounding))
+    }
+
+    override func entryForXValue(_ xValue: Double, closestToY yValue: Double) -> ChartDataEntry? {
+        return entryForXValue(xValue, closestToY: yValue, rounding: .closest)
+    }
+
+    override func entriesForXValue(_ xValue: Double) -> [ChartDataEntry] {
+        var result: [ChartDataEntry] = []
+        var index = lowerBound(x: xValue)
+        while index < entryCount && xStorage[head + index] == xValue {
+            if !yStorage[head + index].isNaN {
+                result.append(ChartDataEntry(x: xValue, y: yStorage[head + index]))
+            }
+            index += 1
+        }
+        return result
+    }
+
+    override func addEntry(_ e: ChartDataEntry) -> Bool {
+        append(x: e.x, y: e.y)
+        return true
+    }
+
+    override func addEntryOrdered(_ e: ChartDataEntry) -> Bool {
+        // Rare for these series, so take the O(n) path: insert, then rebuild the bounds
+        let index = head + lowerBound(x: e.x + Double.ulpOfOne * Swift.max(1, abs(e.x)))
+        xStorage.insert(e.x, at: index)
+        yStorage.insert(e.y, at: index)
+        rebuildBounds()
+        return true
+    }
+
+    override func clear() {
+        removeAllValues(keepingCapacity: true)
+    }
+
+    // MARK: - NSCopying
+
+    override func copy(with zone: NSZone? = nil) -> Any {
+        let copy = super.copy(with: zone) as! ContiguousLineChartDataSet
+        copy.xStorage = xStorage
+        copy.yStorage = yStorage
+        copy.head = head
+        copy.version = version
+        copy.rewriteVersion = rewriteVersion
+        copy.removedCount = removedCount
+        copy.windowBounds = windowBounds
+        copy.rangeTree = rangeTree
+        copy.rangeBounds = rangeBounds
+        copy.isLookupTableEnabled = isLookupTableEnabled
+        return copy
+    }
+}
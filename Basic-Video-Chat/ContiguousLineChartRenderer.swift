@@ -0,0 +1,354 @@
+//
+//  ContiguousLineChartRenderer.swift
+//  Basic-Video-Chat
+//
+//  Line renderer that draws ContiguousLineChartDataSet straight from its x/y
+//  buffers: the visible range is found by binary search and the line and
+//  fill paths are built without materialising a ChartDataEntry per point.
+//  Other data sets, and styles this path doesn't cover (per-segment colors,
+//  gradient lines), go through the stock DGCharts implementation.
+//
+//  When the visible range is denser than the screen, points sharing a pixel
+//  column are collapsed to that column's first, min, max and last point (M4)
+//  before the path is built, which draws the same pixels at a cost bounded
+//  by the chart width.
+//
+//  Built paths are cached per data set in value space, so a live chart whose
+//  axes move every flush keeps them: appended points are added to the cached
+//  paths, and trimming points off the front rebuilds them from what is left.
+//  The pixel-space copy drawn last is kept next to them and reused until the
+//  points or the matrix change. Aggregated paths depend on pixel columns and
+//  are cached in pixels only.
+//
+
+import UIKit
+import DGCharts
+
+class ContiguousLineChartRenderer: LineChartRenderer {
+    /// Collapse dense ranges to at most four points per pixel column. Ignored for stepped lines.
+    var isColumnAggregationEnabled = true
+
+    /// Width of one device pixel in points
+    var columnWidth: CGFloat = 1 / UIScreen.main.scale
+
+    // Points being added to a path and their column aggregate, reused across frames
+    private var pixelBuffer: [CGPoint] = []
+    private var aggregateBuffer: [CGPoint] = []
+
+    private var geometryCache: [ObjectIdentifier: CachedGeometry] = [:]
+
+    convenience init(chartView: LineChartView) {
+        self.init(dataProvider: chartView, animator: chartView.chartAnimator, viewPortHandler: chartView.viewPortHandler)
+    }
+
+    override func drawData(context: CGContext) {
+        // Forget geometry of data sets that left the chart
+        if let dataSets = dataProvider?.lineData?.dataSets {
+            let current = Set(dataSets.map { ObjectIdentifier($0) })
+            geometryCache = geometryCache.filter { current.contains($0.key) }
+        }
+        super.drawData(context: context)
+    }
+
+    override func drawLinear(context: CGContext, dataSet: LineChartDataSetProtocol) {
+        guard let contiguous = dataSet as? ContiguousLineChartDataSet,
+              contiguous.colors.count <= 1,
+              !contiguous.isDrawLineWithGradientEnabled,
+              let dataProvider = dataProvider else {
+            super.drawLinear(context: context, dataSet: dataSet)
+            return
+        }
+
+        let range = contiguous.visibleIndexRange(fromX: dataProvider.lowestVisibleX,
+                                                 toX: dataProvider.highestVisibleX,
+                                                 phaseX: animator.phaseX)
+        guard !range.isEmpty else { return }
+
+        let trans = dataProvider.getTransformer(forAxis: contiguous.axisDependency)
+        let fillMin = contiguous.fillFormatter?.getFillLinePosition(dataSet: contiguous, dataProvider: dataProvider) ?? 0
+        let paths = geometry(for: contiguous, range: range, fillMin: fillMin, transformer: trans)
+
+        if let fillPath = paths.fillPath {
+            if let fill = contiguous.fill {
+                drawFilledPath(context: context, path: fillPath, fill: fill, fillAlpha: contiguous.fillAlpha)
+            } else {
+                drawFilledPath(context: context, path: fillPath, fillColor: contiguous.fillColor, fillAlpha: contiguous.fillAlpha)
+            }
+        }
+
+        context.saveGState()
+        defer { context.restoreGState() }
+        context.beginPath()
+        context.addPath(paths.line)
+        context.setStrokeColor(contiguous.color(atIndex: 0).cgColor)
+        context.strokePath()
+    }
+
+    /// Line and fill paths in pixels for `range`, from cached geometry where it still applies.
+    private func geometry(for dataSet: ContiguousLineChartDataSet,
+                          range: Range<Int>,
+                          fillMin: Double,
+                          transformer: Transformer) -> (line: CGPath, fillPath: CGPath?) {
+        let columnCount = Int(viewPortHandler.contentWidth / columnWidth)
+        let isStepped = dataSet.mode == .stepped
+        let aggregates = isColumnAggregationEnabled && !isStepped && range.count > columnCount * 4
+
+        guard !aggregates else {
+            // Columns are pixel positions, so aggregated paths are built in pixels
+            let key = GeometryKey(
+                matrix: transformer.valueToPixelMatrix,
+                phaseY: animator.phaseY,
+                isStepped: isStepped,
+                fillBaseline: dataSet.isDrawFilledEnabled
+                    ? CGPoint(x: 0, y: fillMin).applying(transformer.valueToPixelMatrix).y
+                    : nil)
+            let builder = aggregatedGeometry(for: dataSet, range: range, key: key, transformer: transformer).builder
+            return (builder.line, builder.fillPath)
+        }
+
+        let key = GeometryKey(
+            matrix: nil,
+            phaseY: animator.phaseY,
+            isStepped: isStepped,
+            fillBaseline: dataSet.isDrawFilledEnabled ? CGFloat(fillMin) : nil)
+        var cached = valueGeometry(for: dataSet, range: range, key: key)
+        let matrix = transformer.valueToPixelMatrix
+        if let pixels = cached.pixelPaths, pixels.matrix == matrix, pixels.points == cached.points {
+            return (pixels.line, pixels.fillPath)
+        }
+
+        var transform = matrix
+        let line = cached.builder.line.copy(using: &transform) ?? cached.builder.line
+        let fillPath = cached.builder.fillPath.map { $0.copy(using: &transform) ?? $0 }
+        cached.pixelPaths = PixelPaths(matrix: matrix, points: cached.points, line: line, fillPath: fillPath)
+        geometryCache[ObjectIdentifier(dataSet)] = cached
+        return (line, fillPath)
+    }
+
+    /// Paths in value space, so moving axes and scrolling don't invalidate them. Appended points
+    /// extend the cached paths. Points scrolled off the left stay in them until they outweigh the
+    /// visible ones; points removed from the data set make the paths rebuild without them.
+    private func valueGeometry(for dataSet: ContiguousLineChartDataSet,
+                               range: Range<Int>,
+                               key: GeometryKey) -> CachedGeometry {
+        let id = ObjectIdentifier(dataSet)
+        let points = (dataSet.removedCount + range.lowerBound) ..< (dataSet.removedCount + range.upperBound)
+
+        if var cached = geometryCache[id],
+           cached.key == key,
+           cached.rewriteVersion == dataSet.rewriteVersion,
+           cached.points.lowerBound >= dataSet.removedCount,
+           cached.points.lowerBound <= points.lowerBound,
+           (points.lowerBound ... points.upperBound).contains(cached.points.upperBound),
+           points.lowerBound - cached.points.lowerBound <= points.count {
+            if cached.points.upperBound < points.upperBound {
+                let tail = (cached.points.upperBound - dataSet.removedCount) ..< range.upperBound
+                ContiguousLineChartRenderer.valuePoints(of: dataSet, range: tail, phaseY: key.phaseY, into: &pixelBuffer)
+                cached.builder.add(contentsOf: pixelBuffer)
+                cached.points = cached.points.lowerBound ..< points.upperBound
+                geometryCache[id] = cached
+            }
+            return cached
+        }
+
+        ContiguousLineChartRenderer.valuePoints(of: dataSet, range: range, phaseY: key.phaseY, into: &pixelBuffer)
+        let builder = LinePathBuilder(isStepped: key.isStepped, fillBaseline: key.fillBaseline)
+        builder.add(contentsOf: pixelBuffer)
+        let geometry = CachedGeometry(key: key, rewriteVersion: dataSet.rewriteVersion, points: points, builder: builder)
+        geometryCache[id] = geometry
+        return geometry
+    }
+
+    /// Column-aggregated paths in pixels, reused while the same points are drawn with the same matrix.
+    private func aggregatedGeometry(for dataSet: ContiguousLineChartDataSet,
+                                    range: Range<Int>,
+                                    key: GeometryKey,
+                                    transformer: Transformer) -> CachedGeometry {
+        let id = ObjectIdentifier(dataSet)
+        let points = (dataSet.removedCount + range.lowerBound) ..< (dataSet.removedCount + range.upperBound)
+
+        if let cached = geometryCache[id],
+           cached.key == key,
+           cached.rewriteVersion == dataSet.rewriteVersion,
+           cached.points == points {
+            return cached
+        }
+
+        transformer.pixelPoints(xValues: dataSet.xValues,
+                                yValues: dataSet.yValues,
+                                range: range,
+                                phaseY: key.phaseY,
+                                into: &pixelBuffer)
+        ContiguousLineChartRenderer.aggregateColumns(pixelBuffer, columnWidth: columnWidth, into: &aggregateBuffer)
+
+        let builder = LinePathBuilder(isStepped: key.isStepped, fillBaseline: key.fillBaseline)
+        builder.add(contentsOf: aggregateBuffer)
+        let geometry = CachedGeometry(key: key, rewriteVersion: dataSet.rewriteVersion, points: points, builder: builder)
+        geometryCache[id] = geometry
+        return geometry
+    }
+
+    /// `(x, y * phaseY)` of every logical index in `range`, through the batch transform kernel.
+    private static func valuePoints(of dataSet: ContiguousLineChartDataSet, range: Range<Int>, phaseY: Double,
+                                    into points: inout [CGPoint]) {
+        if points.count != range.count {
+            points = [CGPoint](repeating: .zero, count: range.count)
+        }
+        dataSet.xValues.withUnsafeBufferPointer { xs in
+            dataSet.yValues.withUnsafeBufferPointer { ys in
+                points.withUnsafeMutableBufferPointer { out in
+                    Transformer.transform(xs: UnsafeBufferPointer(rebasing: xs[range]),
+                                          ys: UnsafeBufferPointer(rebasing: ys[range]),
+                                          phaseY: phaseY,
+                                          matrix: .identity,
+                                          into: out)
+                }
+            }
+        }
+    }
+
+    /// M4 aggregation: keeps the first, lowest, highest and last point of every `columnWidth`
+    /// wide column, in their original order. Gap points (NaN y) are passed through and end the
+    /// column they fall in, so segments are never joined.
+    static func aggregateColumns(_ pixels: [CGPoint], columnWidth: CGFloat, into out: inout [CGPoint]) {
+        out.removeAll(keepingCapacity: true)
+
+        var column = Int.min
+        var first = 0, low = 0, high = 0, last = 0
+        var isOpen = false
+
+        func flush() {
+            guard isOpen else { return }
+            // Emit in index order, skipping duplicates when a point plays several roles
+            let inner = low < high ? (low, high) : (high, low)
+            out.append(pixels[first])
+            if inner.0 != first { out.append(pixels[inner.0]) }
+            if inner.1 != inner.0 && inner.1 != first { out.append(pixels[inner.1]) }
+            if last != inner.1 && last != first { out.append(pixels[last]) }
+            isOpen = false
+        }
+
+        for i in pixels.indices {
+            let point = pixels[i]
+            if point.y.isNaN {
+                flush()
+                out.append(point)
+                column = Int.min
+                continue
+            }
+
+            let pointColumn = Int((point.x / columnWidth).rounded(.down))
+            if !isOpen || pointColumn != column {
+                flush()
+                column = pointColumn
+                first = i
+                low = i
+                high = i
+                isOpen = true
+            } else {
+                if point.y < pixels[low].y { low = i }
+                if point.y > pixels[high].y { high = i }
+            }
+            last = i
+        }
+        flush()
+    }
+}
+
+/// Everything besides the points themselves that the built paths depend on.
+private struct GeometryKey: Equatable {
+    /// Value-to-pixel matrix baked into the paths, nil for paths in value space
+    let matrix: CGAffineTransform?
+    let phaseY: Double
+    let isStepped: Bool
+    /// In the same space as the paths
+    let fillBaseline: CGFloat?
+}
+
+private struct CachedGeometry {
+    let key: GeometryKey
+    let rewriteVersion: Int
+    /// Points in the paths, as `removedCount + index` so front removals don't shift them
+    var points: Range<Int>
+    let builder: LinePathBuilder
+    /// Value-space paths mapped to pixels when last drawn
+    var pixelPaths: PixelPaths?
+}
+
+private struct PixelPaths {
+    let matrix: CGAffineTransform
+    /// The cached points when these were mapped; the builder only grows, so this tells if it did
+    let points: Range<Int>
+    let line: CGPath
+    let fillPath: CGPath?
+}
+
+/// Accumulates the stroke path from points and, when `fillBaseline` is set, a fill path per
+/// segment down to that y. A NaN y lifts the pen, so gaps are neither stroked nor filled.
+/// Chart matrices only scale and translate, so the baseline stays one y for all x in pixels too.
+/// Points can be added after the paths were drawn, which is how cached geometry grows.
+private final class LinePathBuilder {
+    let line = CGMutablePath()
+    private let fill: CGMutablePath?
+    private let isStepped: Bool
+    private let fillBaseline: CGFloat?
+    private var isPenDown = false
+    private var last = CGPoint.zero
+    private var closedFill: CGPath?
+
+    init(isStepped: Bool, fillBaseline: CGFloat?) {
+        self.isStepped = isStepped
+        self.fillBaseline = fillBaseline
+        fill = fillBaseline == nil ? nil : CGMutablePath()
+    }
+
+    /// The fill with the segment still being drawn closed down to the baseline.
+    var fillPath: CGPath? {
+        guard let fill = fill, let fillBaseline = fillBaseline else { return nil }
+        guard isPenDown else { return fill }
+        if let closedFill = closedFill {
+            return closedFill
+        }
+        let closed = fill.mutableCopy() ?? CGMutablePath()
+        closed.addLine(to: CGPoint(x: last.x, y: fillBaseline))
+        closed.closeSubpath()
+        closedFill = closed
+        return closed
+    }
+
+    func add<S: Sequence>(contentsOf points: S) where S.Element == CGPoint {
+        closedFill = nil
+        for point in points {
+            add(point)
+        }
+    }
+
+    private func add(_ point: CGPoint) {
+        if point.y.isNaN {
+            if let fill = fill, let fillBaseline = fillBaseline, isPenDown {
+                fill.addLine(to: CGPoint(x: last.x, y: fillBaseline))
+                fill.closeSubpath()
+            }
+            isPenDown = false
+            return
+        }
+
+        if !isPenDown {
+            line.move(to: point)
+            if let fillBaseline = fillBaseline {
+                fill?.move(to: CGPoint(x: point.x, y: fillBaseline))
+                fill?.addLine(to: point)
+            }
+            isPenDown = true
+        } else {
+            if isStepped {
+                let step = CGPoint(x: point.x, y: last.y)
+                line.addLine(to: step)
+                fill?.addLine(to: step)
+            }
+            line.addLine(to: point)
+            fill?.addLine(to: point)
+        }
+        last = point
+    }
+}
@@ -0,0 +1,132 @@
+//
+//  DataApproximator+LTTB.swift
+//  Basic-Video-Chat
+//
+//  Linear-time alternatives to the Douglas-Peucker reducers in DGCharts.
+//  Both run in a single pass over a contiguous point buffer and keep the
+//  first and last point, like the existing approximators.
+//
+
+import Foundation
+import CoreGraphics
+import DGCharts
+
+extension DataApproximator {
+    /// Largest-Triangle-Three-Buckets: splits the interior points into `resultCount - 2` buckets
+    /// and keeps, per bucket, the point forming the largest triangle with the previously kept point
+    /// and the average of the next bucket. O(n), visually faithful on noisy traces.
+    /// More algorithm details here - https://skemman.is/handle/1946/15343
+    class func reduceWithLargestTriangleThreeBuckets(_ points: [CGPoint], resultCount: Int) -> [CGPoint] {
+        // if a shape has 2 or less points it cannot be reduced
+        if resultCount <= 2 || resultCount >= points.count {
+            return points
+        }
+
+        return points.withUnsafeBufferPointer { buffer in
+            var reduced = [CGPoint]()
+            reduced.reserveCapacity(resultCount)
+            largestTriangleThreeBuckets(buffer, resultCount: resultCount) { reduced.append($0) }
+            return reduced
+        }
+    }
+
+    /// Min/max-preserving variant: splits the interior points into `(resultCount - 2) / 2` buckets
+    /// and keeps both the lowest and the highest point of each, in x order. Unlike LTTB it never
+    /// drops a spike, at the cost of a slightly busier line.
+    class func reduceWithMinMax(_ points: [CGPoint], resultCount: Int) -> [CGPoint] {
+        // need room for the first and last point plus at least one bucket
+        if resultCount < 4 || resultCount >= points.count {
+            return points
+        }
+
+        return points.withUnsafeBufferPointer { buffer in
+            var reduced = [CGPoint]()
+            reduced.reserveCapacity(resultCount)
+            minMax(buffer, resultCount: resultCount) { reduced.append($0) }
+            return reduced
+        }
+    }
+
+    // MARK: - Buffer kernels
+
+    /// LTTB over a raw buffer, emitting kept points through `emit` so callers can write straight
+    /// into their own storage. Requires `2 < resultCount < points.count`.
+    static func largestTriangleThreeBuckets(_ points: UnsafeBufferPointer<CGPoint>,
+                                            resultCount: Int,
+                                            emit: (CGPoint) -> Void) {
+        let count = points.count
+        let bucketSize = Double(count - 2) / Double(resultCount - 2)
+
+        var kept = points[0]
+        emit(kept)
+
+        for bucket in 0 ..< resultCount - 2 {
+            // Average of the next bucket is the third triangle vertex
+            // (for the last bucket that is just the final point)
+            let nextStart = min(Int(Double(bucket + 1) * bucketSize) + 1, count - 1)
+            let nextEnd = max(min(Int(Double(bucket + 2) * bucketSize) + 1, count), nextStart + 1)
+            var avgX: CGFloat = 0
+            var avgY: CGFloat = 0
+            for i in nextStart ..< nextEnd {
+                avgX += points[i].x
+                avgY += points[i].y
+            }
+            let nextCount = CGFloat(nextEnd - nextStart)
+            avgX /= nextCount
+            avgY /= nextCount
+
+            let start = Int(Double(bucket) * bucketSize) + 1
+            let end = max(min(Int(Double(bucket + 1) * bucketSize) + 1, count - 1), start + 1)
+
+            // Twice the triangle area; the constant factor doesn't change the argmax
+            var maxArea: CGFloat = -1
+            var selected = points[start]
+            for i in start ..< end {
+                let p = points[i]
+                let area = abs((kept.x - avgX) * (p.y - kept.y) - (kept.x - p.x) * (avgY - kept.y))
+                if area > maxArea {
+                    maxArea = area
+                    selected = p
+                }
+            }
+
+            emit(selected)
+            kept = selected
+        }
+
+        emit(points[count - 1])
+    }
+
+    /// Min/max bucketing over a raw buffer. Requires `4 <= resultCount < points.count`.
+    static func minMax(_ points: UnsafeBufferPointer<CGPoint>,
+                       resultCount: Int,
+                       emit: (CGPoint) -> Void) {
+        let count = points.count
+        let bucketCount = (resultCount - 2) / 2
+        let bucketSize = Double(count - 2) / Double(bucketCount)
+
+        emit(points[0])
+
+        for bucket in 0 ..< bucketCount {
+            let start = Int(Double(bucket) * bucketSize) + 1
+            let end = min(Int(Double(bucket + 1) * bucketSize) + 1, count - 1)
+            guard start < end else { continue }
+
+            var minIndex = start
+            var maxIndex = start
+            for i in start + 1 ..< end {
+                if points[i].y < points[minIndex].y { minIndex = i }
+                if points[i].y > points[maxIndex].y { maxIndex = i }
+            }
+
+            if minIndex == maxIndex {
+                emit(points[minIndex])
+            } else {
+                emit(points[min(minIndex, maxIndex)])
+                emit(points[max(minIndex, maxIndex)])
+            }
+        }
+
+        emit(points[count - 1])
+    }
+}
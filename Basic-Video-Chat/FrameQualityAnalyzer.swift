@@ -0,0 +1,215 @@
+//
+//  FrameQualityAnalyzer.swift
+//  Basic-Video-Chat
+//
+//  What the viewer actually sees, measured per rendered frame and reported
+//  per stats window:
+//
+//  - frame rate and inter-frame interval jitter,
+//  - freezes, using WebRTC's definition: an interval longer than both
+//    3x the average interval and the average plus 150 ms,
+//  - blockiness and sharpness of the picture, from horizontal luma
+//    differences on every `rowStep`-th row. Blockiness compares differences
+//    across 8-pixel block boundaries to those inside blocks (about 1 for a
+//    clean picture); sharpness is the mean absolute difference and falls as
+//    the picture blurs.
+//
+//  Stamped frames add glass-to-glass latency and, for SyntheticPattern
+//  streams, scores against their reference (PSNR, SSIM); see FrameStamp.swift.
+//
+//  Only Foundation is used and frames come in as plain luma planes, so the
+//  analysis runs the same on synthetic frames off iOS.
+//
+
+import Foundation
+
+/// Frame-level quality of one subscriber over one stats window. Timestamps are in
+/// milliseconds, on the same clock as `VideoStats.timestamp`.
+struct FrameQualityStats {
+    let streamId: String
+    let timestamp: TimeInterval
+    let frameCount: Int
+    let frameRate: Double
+    let intervalJitterMs: Double
+    let freezeCount: Int
+    let freezeDurationMs: Double
+    let blockiness: Double
+    let sharpness: Double
+    // Means over the frames scored against their reference, nil without a stamped stream
+    let psnr: Double?
+    let ssim: Double?
+    // Capture to render, over the stamped frames; nil until the publisher's clock offset is known
+    let latencyMs: Double?
+    let maxLatencyMs: Double?
+    let qodEnabled: Bool
+}
+
+/// A borrowed 8-bit luma plane.
+struct LumaPlane {
+    var pixels: UnsafePointer<UInt8>
+    var stride: Int
+    var width: Int
+    var height: Int
+}
+
+final class FrameQualityAnalyzer {
+    let streamId: String
+    /// Analyze every n-th luma row; higher is cheaper and coarser
+    let rowStep: Int
+
+    // Frames arrive on the renderer's thread, windows are taken from the stats timer
+    private let lock = NSLock()
+    private var lastArrival: TimeInterval?
+    private var averageIntervalMs: Double?
+    private var window = Window()
+
+    private struct Window {
+        var startTime: TimeInterval?
+        var frameCount = 0
+        var intervalCount = 0
+        var intervalSum = 0.0
+        var intervalSquareSum = 0.0
+        var freezeCount = 0
+        var freezeDurationMs = 0.0
+        var scoredFrameCount = 0
+        var blockinessSum = 0.0
+        var sharpnessSum = 0.0
+        var referenceCount = 0
+        var psnrSum = 0.0
+        var ssimSum = 0.0
+        var latencyCount = 0
+        var latencySum = 0.0
+        var latencyMax = -Double.greatestFiniteMagnitude
+    }
+
+    init(streamId: String, rowStep: Int = 4) {
+        self.streamId = streamId
+        self.rowStep = max(1, rowStep)
+    }
+
+    /// Records a rendered frame. `arrivalTime` is in seconds on a monotonic clock; pass nil
+    /// for `luma` when the frame has no 8-bit luma plane and only timing should count.
+    func addFrame(arrivalTime: TimeInterval, luma: LumaPlane?) {
+        let scores = luma.map { FrameQualityAnalyzer.contentScores($0, rowStep: rowStep) }
+
+        lock.lock()
+        defer { lock.unlock() }
+
+        if window.startTime == nil {
+            window.startTime = arrivalTime
+        }
+        window.frameCount += 1
+        if let scores = scores {
+            window.scoredFrameCount += 1
+            window.blockinessSum += scores.blockiness
+            window.sharpnessSum += scores.sharpness
+        }
+
+        defer { lastArrival = arrivalTime }
+        guard let last = lastArrival else { return }
+        let intervalMs = (arrivalTime - last) * 1000
+        window.intervalCount += 1
+        window.intervalSum += intervalMs
+        window.intervalSquareSum += intervalMs * intervalMs
+
+        if let average = averageIntervalMs, intervalMs > max(3 * average, average + 150) {
+            window.freezeCount += 1
+            window.freezeDurationMs += intervalMs
+            // A freeze says nothing about the normal frame interval, keep it out of the average
+            return
+        }
+        averageIntervalMs = averageIntervalMs.map { $0 * 0.9 + intervalMs * 0.1 } ?? intervalMs
+    }
+
+    /// Forgets the last frame's arrival, so the gap across a deliberate video pause isn't
+    /// counted as a freeze when frames come back.
+    func resetTiming() {
+        lock.lock()
+        defer { lock.unlock() }
+        lastArrival = nil
+    }
+
+    /// Records a frame's full-reference scores.
+    func addReferenceScore(psnr: Double, ssim: Double) {
+        lock.lock()
+        defer { lock.unlock() }
+        window.referenceCount += 1
+        window.psnrSum += psnr
+        window.ssimSum += ssim
+    }
+
+    /// Records a frame's capture-to-render latency.
+    func addLatency(milliseconds: Double) {
+        lock.lock()
+        defer { lock.unlock() }
+        window.latencyCount += 1
+        window.latencySum += milliseconds
+        window.latencyMax = max(window.latencyMax, milliseconds)
+    }
+
+    /// Summarises the frames since the last call and starts a new window.
+    func takeWindow(timestamp: TimeInterval, now: TimeInterval, qodEnabled: Bool) -> FrameQualityStats {
+        lock.lock()
+        let finished = window
+        window = Window()
+        window.startTime = now
+        lock.unlock()
+
+        let elapsed = finished.startTime.map { now - $0 } ?? 0
+        let meanInterval = finished.intervalCount > 0 ? finished.intervalSum / Double(finished.intervalCount) : 0
+        let variance = finished.intervalCount > 0
+            ? max(0, finished.intervalSquareSum / Double(finished.intervalCount) - meanInterval * meanInterval)
+            : 0
+        let scored = Double(max(1, finished.scoredFrameCount))
+        let referenced = Double(finished.referenceCount)
+
+        return FrameQualityStats(
+            streamId: streamId,
+            timestamp: timestamp,
+            frameCount: finished.frameCount,
+            frameRate: elapsed > 0 ? Double(finished.frameCount) / elapsed : 0,
+            intervalJitterMs: variance.squareRoot(),
+            freezeCount: finished.freezeCount,
+            freezeDurationMs: finished.freezeDurationMs,
+            blockiness: finished.scoredFrameCount > 0 ? finished.blockinessSum / scored : 0,
+            sharpness: finished.scoredFrameCount > 0 ? finished.sharpnessSum / scored : 0,
+            psnr: finished.referenceCount > 0 ? finished.psnrSum / referenced : nil,
+            ssim: finished.referenceCount > 0 ? finished.ssimSum / referenced : nil,
+            latencyMs: finished.latencyCount > 0 ? finished.latencySum / Double(finished.latencyCount) : nil,
+            maxLatencyMs: finished.latencyCount > 0 ? finished.latencyMax : nil,
+            qodEnabled: qodEnabled
+        )
+    }
+
+    /// Blockiness and sharpness of one frame, see the file header.
+    static func contentScores(_ luma: LumaPlane, rowStep: Int) -> (blockiness: Double, sharpness: Double) {
+        guard luma.width > 8, luma.height > 0 else { return (1, 0) }
+
+        var boundarySum = 0, boundaryCount = 0
+        var interiorSum = 0, interiorCount = 0
+        for row in Swift.stride(from: rowStep / 2, to: luma.height, by: rowStep) {
+            let line = luma.pixels + row * luma.stride
+            var previous = Int(line[0])
+            for column in 1 ..< luma.width {
+                let value = Int(line[column])
+                let difference = abs(value - previous)
+                previous = value
+                if column & 7 == 0 {
+                    boundarySum += difference
+                    boundaryCount += 1
+                } else {
+                    interiorSum += difference
+                    interiorCount += 1
+                }
+            }
+        }
+        guard boundaryCount > 0, interiorCount > 0 else { return (1, 0) }
+
+        let boundaryMean = Double(boundarySum) / Double(boundaryCount)
+        let interiorMean = Double(interiorSum) / Double(interiorCount)
+        // The +1 keeps flat pictures from dividing by nearly zero
+        let blockiness = (boundaryMean + 1) / (interiorMean + 1)
+        let sharpness = Double(boundarySum + interiorSum) / Double(boundaryCount + interiorCount)
+        return (blockiness, sharpness)
+    }
+}
@@ -0,0 +1,177 @@
+//
+//  main.swift
+//  FrameQualityAnalyzerTest
+//
+//  Command line test for FrameQualityAnalyzer, built from the app's own
+//  source so it runs anywhere Swift does, Linux included:
+//
+//    swiftc -O Basic-Video-Chat/FrameQualityAnalyzer.swift \
+//        Basic-Video-Chat/FrameQualityAnalyzerTest/main.swift -o frame-quality-analyzer-test
+//    ./frame-quality-analyzer-test
+//
+//  Feeds the analyzer synthetic arrival times with known freeze gaps and
+//  synthetic luma planes with known structure, then checks the windows it
+//  reports. Exits with a non-zero status on the first failed check.
+//
+
+import Foundation
+
+private func check(_ condition: @autoclosure () -> Bool, _ message: @autoclosure () -> String) {
+    guard condition() else {
+        FileHandle.standardError.write("FAILED: \(message())\n".data(using: .utf8)!)
+        exit(1)
+    }
+}
+
+private func isClose(_ a: Double, _ b: Double, within tolerance: Double = 1e-6) -> Bool {
+    return abs(a - b) <= tolerance
+}
+
+/// A `width` x `height` luma plane whose pixel at (x, y) is `value(x, y)`.
+private func withPlane(width: Int, height: Int, _ value: (Int, Int) -> UInt8, _ body: (LumaPlane) -> Void) {
+    var pixels = [UInt8](repeating: 0, count: width * height)
+    for y in 0 ..< height {
+        for x in 0 ..< width {
+            pixels[y * width + x] = value(x, y)
+        }
+    }
+    pixels.withUnsafeBufferPointer { buffer in
+        body(LumaPlane(pixels: buffer.baseAddress!, stride: width, width: width, height: height))
+    }
+}
+
+private let frameInterval = 1.0 / 30
+
+/// Adds `count` timing-only frames `interval` seconds apart after `start`, returns the last arrival.
+@discardableResult
+private func addFrames(_ analyzer: FrameQualityAnalyzer, count: Int, from start: TimeInterval,
+                       interval: TimeInterval = frameInterval) -> TimeInterval {
+    var arrival = start
+    for _ in 0 ..< count {
+        arrival += interval
+        analyzer.addFrame(arrivalTime: arrival, luma: nil)
+    }
+    return arrival
+}
+
+// MARK: - Timing
+
+do {
+    // 90 evenly spaced frames over 3 s
+    let analyzer = FrameQualityAnalyzer(streamId: "steady")
+    let last = addFrames(analyzer, count: 90, from: 0)
+    let stats = analyzer.takeWindow(timestamp: 1000, now: last + frameInterval, qodEnabled: true)
+    check(stats.frameCount == 90, "steady: counted \(stats.frameCount) frames, expected 90")
+    check(isClose(stats.frameRate, 30, within: 0.01), "steady: frame rate \(stats.frameRate), expected 30")
+    check(isClose(stats.intervalJitterMs, 0, within: 1e-3), "steady: jitter \(stats.intervalJitterMs) ms, expected 0")
+    check(stats.freezeCount == 0, "steady: counted \(stats.freezeCount) freezes, expected none")
+    check(stats.streamId == "steady" && stats.timestamp == 1000 && stats.qodEnabled, "steady: window labels lost")
+}
+
+do {
+    // At 30 fps a freeze is an interval over max(3 x 33 ms, 33 + 150 ms), about 183 ms
+    let analyzer = FrameQualityAnalyzer(streamId: "freezes")
+    var arrival = addFrames(analyzer, count: 30, from: 0)
+    arrival = addFrames(analyzer, count: 1, from: arrival, interval: 0.150)
+    arrival = addFrames(analyzer, count: 30, from: arrival)
+    arrival = addFrames(analyzer, count: 1, from: arrival, interval: 0.400)
+    arrival = addFrames(analyzer, count: 30, from: arrival)
+    arrival = addFrames(analyzer, count: 1, from: arrival, interval: 0.700)
+    arrival = addFrames(analyzer, count: 30, from: arrival)
+    let stats = analyzer.takeWindow(timestamp: 0, now: arrival, qodEnabled: false)
+    check(stats.freezeCount == 2, "freezes: counted \(stats.freezeCount), expected the 400 and 700 ms gaps")
+    check(isClose(stats.freezeDurationMs, 1100, within: 1e-3),
+          "freezes: \(stats.freezeDurationMs) ms frozen, expected 1100")
+    check(stats.intervalJitterMs > 0, "freezes: uneven intervals reported no jitter")
+
+    // The next window starts from scratch
+    arrival = addFrames(analyzer, count: 30, from: arrival)
+    let next = analyzer.takeWindow(timestamp: 0, now: arrival, qodEnabled: false)
+    check(next.frameCount == 30 && next.freezeCount == 0, "freezes: the next window kept the previous one's counts")
+}
+
+do {
+    // A deliberate pause is not a freeze once timing is reset
+    let analyzer = FrameQualityAnalyzer(streamId: "paused")
+    var arrival = addFrames(analyzer, count: 30, from: 0)
+    analyzer.resetTiming()
+    arrival = addFrames(analyzer, count: 30, from: arrival + 5)
+    let stats = analyzer.takeWindow(timestamp: 0, now: arrival, qodEnabled: false)
+    check(stats.freezeCount == 0, "paused: the gap across resetTiming() counted as \(stats.freezeCount) freeze(s)")
+    check(stats.frameCount == 60, "paused: counted \(stats.frameCount) frames, expected 60")
+}
+
+// MARK: - Picture content
+
+do {
+    let flat = { (_: Int, _: Int) -> UInt8 in 128 }
+    withPlane(width: 64, height: 32, flat) { plane in
+        let scores = FrameQualityAnalyzer.contentScores(plane, rowStep: 1)
+        check(isClose(scores.blockiness, 1) && isClose(scores.sharpness, 0),
+              "flat: blockiness \(scores.blockiness), sharpness \(scores.sharpness), expected 1 and 0")
+    }
+
+    // Constant 8-pixel blocks: every difference sits on a block boundary
+    let blocks = { (x: Int, _: Int) -> UInt8 in UInt8(truncatingIfNeeded: (x / 8) * 40) }
+    withPlane(width: 64, height: 32, blocks) { plane in
+        let scores = FrameQualityAnalyzer.contentScores(plane, rowStep: 1)
+        check(scores.blockiness > 10, "blocks: blockiness \(scores.blockiness), expected well above 1")
+    }
+
+    // A smooth ramp differs by the same amount everywhere
+    let ramp = { (x: Int, _: Int) -> UInt8 in UInt8(x * 3) }
+    withPlane(width: 64, height: 32, ramp) { plane in
+        let scores = FrameQualityAnalyzer.contentScores(plane, rowStep: 1)
+        check(isClose(scores.blockiness, 1), "ramp: blockiness \(scores.blockiness), expected 1")
+        check(isClose(scores.sharpness, 3), "ramp: sharpness \(scores.sharpness), expected 3")
+    }
+
+    // Fine detail against the same detail averaged over 4 pixels
+    let detail = { (x: Int, y: Int) -> UInt8 in (x * 7 + y * 13) % 5 < 2 ? 40 : 200 }
+    let blurred = { (x: Int, y: Int) -> UInt8 in
+        UInt8((0 ..< 4).reduce(0) { $0 + Int(detail(min(x + $1, 63), y)) } / 4)
+    }
+    var sharp = 0.0, soft = 0.0
+    withPlane(width: 64, height: 32, detail) { sharp = FrameQualityAnalyzer.contentScores($0, rowStep: 1).sharpness }
+    withPlane(width: 64, height: 32, blurred) { soft = FrameQualityAnalyzer.contentScores($0, rowStep: 1).sharpness }
+    check(sharp > soft, "blur: sharpness \(soft) after blurring, \(sharp) before")
+
+    // Scores are averaged over the frames of a window
+    let analyzer = FrameQualityAnalyzer(streamId: "content", rowStep: 1)
+    withPlane(width: 64, height: 32, ramp) { plane in
+        analyzer.addFrame(arrivalTime: 0, luma: plane)
+    }
+    withPlane(width: 64, height: 32, flat) { plane in
+        analyzer.addFrame(arrivalTime: frameInterval, luma: plane)
+    }
+    analyzer.addFrame(arrivalTime: 2 * frameInterval, luma: nil)
+    let stats = analyzer.takeWindow(timestamp: 0, now: 3 * frameInterval, qodEnabled: false)
+    check(isClose(stats.sharpness, 1.5), "content: window sharpness \(stats.sharpness), expected the mean 1.5")
+    check(isClose(stats.blockiness, 1), "content: window blockiness \(stats.blockiness), expected 1")
+}
+
+// MARK: - Reference scores and latency
+
+do {
+    let analyzer = FrameQualityAnalyzer(streamId: "reference")
+    addFrames(analyzer, count: 2, from: 0)
+    analyzer.addReferenceScore(psnr: 30, ssim: 0.90)
+    analyzer.addReferenceScore(psnr: 40, ssim: 0.95)
+    analyzer.addLatency(milliseconds: 100)
+    analyzer.addLatency(milliseconds: 200)
+    let stats = analyzer.takeWindow(timestamp: 0, now: 1, qodEnabled: true)
+    check(stats.psnr.map { isClose($0, 35) } == true, "reference: PSNR \(String(describing: stats.psnr)), expected 35")
+    check(stats.ssim.map { isClose($0, 0.925) } == true,
+          "reference: SSIM \(String(describing: stats.ssim)), expected 0.925")
+    check(stats.latencyMs.map { isClose($0, 150) } == true,
+          "reference: latency \(String(describing: stats.latencyMs)), expected 150")
+    check(stats.maxLatencyMs.map { isClose($0, 200) } == true,
+          "reference: max latency \(String(describing: stats.maxLatencyMs)), expected 200")
+
+    let empty = analyzer.takeWindow(timestamp: 0, now: 2, qodEnabled: true)
+    check(empty.frameCount == 0 && empty.frameRate == 0, "empty: a window without frames reported some")
+    check(empty.psnr == nil && empty.ssim == nil && empty.latencyMs == nil && empty.maxLatencyMs == nil,
+          "empty: a window without stamped frames reported reference scores or latency")
+}
+
+print("OK")
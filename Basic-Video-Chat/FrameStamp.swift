@@ -0,0 +1,92 @@
+//
+//  FrameStamp.swift
+//  Basic-Video-Chat
+//
+//  What the publisher writes into OTVideoFrame metadata, which carries at
+//  most 32 bytes: the capture time for latency, and for SyntheticPattern
+//  frames the FrameReference needed to rebuild them. Layout, little-endian:
+//
+//    0      "Q"
+//    1      flags, bit 0: a FrameReference follows
+//    2..9   capture time, microseconds since 1970 (Int64)
+//    10..29 frame index (UInt32), width, height (UInt16), motion,
+//           entropy (Float32), seed (UInt32)
+//
+
+import Foundation
+
+/// Identifies a SyntheticPattern frame.
+struct FrameReference: Equatable {
+    var frameIndex: Int
+    var width: Int
+    var height: Int
+    var configuration: SyntheticPattern.Configuration
+}
+
+struct FrameStamp: Equatable {
+    /// Wall-clock seconds since 1970 on the publisher when the frame was captured
+    var captureTime: TimeInterval
+    var reference: FrameReference?
+
+    private static let magic: UInt8 = 0x51   // "Q"
+    private static let hasReference: UInt8 = 1
+
+    init(captureTime: TimeInterval, reference: FrameReference? = nil) {
+        self.captureTime = captureTime
+        self.reference = reference
+    }
+
+    /// Decodes metadata written by `encoded()`, nil for anything else.
+    init?(metadata: Data) {
+        guard metadata.count >= 10, metadata.first == FrameStamp.magic else { return nil }
+        var reader = metadata.dropFirst().makeIterator()
+        func read<T: FixedWidthInteger>(_ type: T.Type) -> T? {
+            var value: T = 0
+            for shift in Swift.stride(from: 0, to: T.bitWidth, by: 8) {
+                guard let byte = reader.next() else { return nil }
+                value |= T(byte) << shift
+            }
+            return value
+        }
+
+        guard let flags = read(UInt8.self), let micros = read(Int64.self) else { return nil }
+        captureTime = TimeInterval(micros) / 1_000_000
+        reference = nil
+        guard flags & FrameStamp.hasReference != 0 else { return }
+
+        guard let frameIndex = read(UInt32.self),
+              let width = read(UInt16.self), let height = read(UInt16.self),
+              let motion = read(UInt32.self), let entropy = read(UInt32.self),
+              let seed = read(UInt32.self),
+              width > 0, height > 0, width % 2 == 0, height % 2 == 0 else { return nil }
+        reference = FrameReference(
+            frameIndex: Int(frameIndex), width: Int(width), height: Int(height),
+            configuration: SyntheticPattern.Configuration(motion: Double(Float(bitPattern: motion)),
+                                                          entropy: Double(Float(bitPattern: entropy)),
+                                                          seed: seed))
+    }
+
+    /// Motion and entropy go out as Float32; SyntheticPattern keeps them at that precision
+    /// so the rebuilt reference matches the original exactly.
+    func encoded() -> Data {
+        var bytes: [UInt8] = [FrameStamp.magic]
+        bytes.reserveCapacity(30)
+        func write<T: FixedWidthInteger>(_ value: T) {
+            for shift in Swift.stride(from: 0, to: T.bitWidth, by: 8) {
+                bytes.append(UInt8(truncatingIfNeeded: value >> shift))
+            }
+        }
+
+        write(reference == nil ? 0 : FrameStamp.hasReference)
+        write(Int64((captureTime * 1_000_000).rounded()))
+        if let reference = reference {
+            write(UInt32(truncatingIfNeeded: reference.frameIndex))
+            write(UInt16(truncatingIfNeeded: reference.width))
+            write(UInt16(truncatingIfNeeded: reference.height))
+            write(Float(reference.configuration.motion).bitPattern)
+            write(Float(reference.configuration.entropy).bitPattern)
+            write(reference.configuration.seed)
+        }
+        return Data(bytes)
+    }
+}
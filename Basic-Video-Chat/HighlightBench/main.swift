@@ -0,0 +1,54 @@
+//
+//  main.swift
+//  HighlightBench
+//
+//  Touch-to-highlight lookup at 1M points: the entry closest to a touched x
+//  in ContiguousLineChartDataSet, by binary search and through its x lookup
+//  table, against the stock LineChartDataSet. Needs the DGCharts module, so
+//  it builds on macOS only (see "Benchmarks" in the README):
+//
+//    swiftc -O -I .bench -L .bench -lDGCharts Basic-Video-Chat/BenchSupport/BenchSupport.swift \
+//        Basic-Video-Chat/ContiguousLineChartDataSet.swift Basic-Video-Chat/SlidingMinMax.swift \
+//        Basic-Video-Chat/XLookupTable.swift Basic-Video-Chat/HighlightBench/main.swift -o highlight-bench
+//    DYLD_LIBRARY_PATH=.bench ./highlight-bench [points]
+//
+//  Touches land at random x values, so lookups don't ride a warm cache line.
+//
+
+import Foundation
+import DGCharts
+
+let pointCount = Bench.argument(1, default: 1_000_000)
+let touchCount = 10_000
+
+var random = BenchRandom()
+let samples = random.series(count: pointCount)
+let xMax = samples.x[pointCount - 1]
+let touches = (0 ..< touchCount).map { _ in Double.random(in: 0 ... xMax, using: &random) }
+print("\(pointCount) points, \(touchCount) touches")
+
+let contiguous = ContiguousLineChartDataSet(entries: [], label: "contiguous")
+contiguous.replaceValues(x: samples.x, y: samples.y)
+let stock = LineChartDataSet(entries: (0 ..< pointCount).map { ChartDataEntry(x: samples.x[$0], y: samples.y[$0]) },
+                             label: "stock")
+
+func measureTouches(_ name: String, _ dataSet: ChartDataSet) -> [Int] {
+    var found = [Int](repeating: 0, count: touchCount)
+    let time = Bench.measure {
+        for (i, x) in touches.enumerated() {
+            found[i] = dataSet.entryIndex(x: x, closestToY: .nan, rounding: .closest)
+        }
+    }
+    Bench.report(name, (time.best / Double(touchCount), time.median / Double(touchCount)), extra: "per touch")
+    return found
+}
+
+let reference = measureTouches("LineChartDataSet", stock)
+let searched = measureTouches("ContiguousLineChartDataSet", contiguous)
+contiguous.isLookupTableEnabled = true
+let tabled = measureTouches("ContiguousLineChartDataSet, lookup table", contiguous)
+
+if searched != reference || tabled != reference {
+    print("FAILED: the data sets disagree on the highlighted entry")
+    exit(1)
+}
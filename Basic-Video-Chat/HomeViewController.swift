@@ -4,6 +4,9 @@ class HomeViewController: UIViewController {
     // MARK: - Properties
     private var msisdn: String = ""
     private var isHighQuality: Bool = false
+    private var isABTestEnabled: Bool = false
+    private var isSyntheticVideoEnabled: Bool = false
+    private var isSubscriberGridEnabled: Bool = false
     
     // MARK: - UI Elements
     private let containerView: UIView = {
@@ -82,6 +85,121 @@ class HomeViewController: UIViewController {
         return toggle
     }()
     
+    private let syntheticVideoContainer: UIView = {
+        let view = UIView()
+        view.translatesAutoresizingMaskIntoConstraints = false
+        view.backgroundColor = .white
+        view.layer.cornerRadius = 8
+        return view
+    }()
+    
+    private let syntheticVideoLabel: UILabel = {
+        let label = UILabel()
+        label.text = "Synthetic test pattern"
+        label.translatesAutoresizingMaskIntoConstraints = false
+        return label
+    }()
+    
+    private let syntheticVideoToggle: UISwitch = {
+        let toggle = UISwitch()
+        toggle.translatesAutoresizingMaskIntoConstraints = false
+        return toggle
+    }()
+    
+    private let motionLabel: UILabel = {
+        let label = UILabel()
+        label.font = .systemFont(ofSize: 15)
+        label.textColor = .gray
+        label.translatesAutoresizingMaskIntoConstraints = false
+        return label
+    }()
+    
+    private let motionSlider: UISlider = {
+        let slider = UISlider()
+        slider.value = Float(SyntheticPattern.Configuration().motion)
+        slider.isEnabled = false
+        slider.translatesAutoresizingMaskIntoConstraints = false
+        return slider
+    }()
+    
+    private let entropyLabel: UILabel = {
+        let label = UILabel()
+        label.font = .systemFont(ofSize: 15)
+        label.textColor = .gray
+        label.translatesAutoresizingMaskIntoConstraints = false
+        return label
+    }()
+    
+    private let entropySlider: UISlider = {
+        let slider = UISlider()
+        slider.value = Float(SyntheticPattern.Configuration().entropy)
+        slider.isEnabled = false
+        slider.translatesAutoresizingMaskIntoConstraints = false
+        return slider
+    }()
+    
+    private let subscriberGridContainer: UIView = {
+        let view = UIView()
+        view.translatesAutoresizingMaskIntoConstraints = false
+        view.backgroundColor = .white
+        view.layer.cornerRadius = 8
+        return view
+    }()
+    
+    private let subscriberGridLabel: UILabel = {
+        let label = UILabel()
+        label.text = "Large session grid"
+        label.translatesAutoresizingMaskIntoConstraints = false
+        return label
+    }()
+    
+    private let subscriberGridToggle: UISwitch = {
+        let toggle = UISwitch()
+        toggle.translatesAutoresizingMaskIntoConstraints = false
+        return toggle
+    }()
+    
+    private let abTestContainer: UIView = {
+        let view = UIView()
+        view.translatesAutoresizingMaskIntoConstraints = false
+        view.backgroundColor = .white
+        view.layer.cornerRadius = 8
+        return view
+    }()
+    
+    private let abTestLabel: UILabel = {
+        let label = UILabel()
+        label.text = "Automated A/B test"
+        label.translatesAutoresizingMaskIntoConstraints = false
+        return label
+    }()
+    
+    private let abTestToggle: UISwitch = {
+        let toggle = UISwitch()
+        toggle.translatesAutoresizingMaskIntoConstraints = false
+        return toggle
+    }()
+    
+    private let windowLengthTextField: UITextField = {
+        let textField = UITextField()
+        textField.placeholder = "Window length (s), default 60"
+        textField.borderStyle = .roundedRect
+        textField.translatesAutoresizingMaskIntoConstraints = false
+        textField.keyboardType = .numberPad
+        textField.isEnabled = false
+        return textField
+    }()
+    
+    private let repeatCountTextField: UITextField = {
+        let textField = UITextField()
+        textField.placeholder = "Repeats, default 3"
+        textField.borderStyle = .roundedRect
+        textField.translatesAutoresizingMaskIntoConstraints = false
+        textField.keyboardType = .numberPad
+        textField.isEnabled = false
+        return textField
+    }()
+    
     private let startButton: UIButton = {
         let button = UIButton(type: .system)
         button.setTitle("Start Network Test", for: .normal)
@@ -98,6 +216,7 @@ class HomeViewController: UIViewController {
         super.viewDidLoad()
         setupUI()
         setupActions()
+        patternSliderChanged()
     }
     
     // MARK: - Setup
@@ -111,10 +230,28 @@ class HomeViewController: UIViewController {
         
         containerView.addSubview(msisdnTextField)
         containerView.addSubview(toggleContainer)
+        containerView.addSubview(syntheticVideoContainer)
+        containerView.addSubview(motionLabel)
+        containerView.addSubview(motionSlider)
+        containerView.addSubview(entropyLabel)
+        containerView.addSubview(entropySlider)
+        containerView.addSubview(subscriberGridContainer)
+        containerView.addSubview(abTestContainer)
+        containerView.addSubview(windowLengthTextField)
+        containerView.addSubview(repeatCountTextField)
         
         toggleContainer.addSubview(toggleLabel)
         toggleContainer.addSubview(qualityToggle)
         
+        syntheticVideoContainer.addSubview(syntheticVideoLabel)
+        syntheticVideoContainer.addSubview(syntheticVideoToggle)
+        
+        subscriberGridContainer.addSubview(subscriberGridLabel)
+        subscriberGridContainer.addSubview(subscriberGridToggle)
+        
+        abTestContainer.addSubview(abTestLabel)
+        abTestContainer.addSubview(abTestToggle)
+        
         NSLayoutConstraint.activate([
             titleLabel.centerXAnchor.constraint(equalTo: view.centerXAnchor),
             titleLabel.topAnchor.constraint(equalTo: view.safeAreaLayoutGuide.topAnchor, constant: 50),
@@ -137,7 +274,50 @@ class HomeViewController: UIViewController {
             toggleContainer.leadingAnchor.constraint(equalTo: containerView.leadingAnchor, constant: 20),
             toggleContainer.trailingAnchor.constraint(equalTo: containerView.trailingAnchor, constant: -20),
             toggleContainer.heightAnchor.constraint(equalToConstant: 44),
-            toggleContainer.bottomAnchor.constraint(equalTo: containerView.bottomAnchor, constant: -20),
+            
+            syntheticVideoContainer.topAnchor.constraint(equalTo: toggleContainer.bottomAnchor, constant: 20),
+            syntheticVideoContainer.leadingAnchor.constraint(equalTo: containerView.leadingAnchor, constant: 20),
+            syntheticVideoContainer.trailingAnchor.constraint(equalTo: containerView.trailingAnchor, constant: -20),
+            syntheticVideoContainer.heightAnchor.constraint(equalToConstant: 44),
+            
+            motionLabel.topAnchor.constraint(equalTo: syntheticVideoContainer.bottomAnchor, constant: 10),
+            motionLabel.leadingAnchor.constraint(equalTo: containerView.leadingAnchor, constant: 36),
+            motionLabel.widthAnchor.constraint(equalToConstant: 110),
+            motionLabel.heightAnchor.constraint(equalToConstant: 32),
+            
+            motionSlider.centerYAnchor.constraint(equalTo: motionLabel.centerYAnchor),
+            motionSlider.leadingAnchor.constraint(equalTo: motionLabel.trailingAnchor, constant: 8),
+            motionSlider.trailingAnchor.constraint(equalTo: containerView.trailingAnchor, constant: -36),
+            
+            entropyLabel.topAnchor.constraint(equalTo: motionLabel.bottomAnchor, constant: 4),
+            entropyLabel.leadingAnchor.constraint(equalTo: motionLabel.leadingAnchor),
+            entropyLabel.widthAnchor.constraint(equalTo: motionLabel.widthAnchor),
+            entropyLabel.heightAnchor.constraint(equalToConstant: 32),
+            
+            entropySlider.centerYAnchor.constraint(equalTo: entropyLabel.centerYAnchor),
+            entropySlider.leadingAnchor.constraint(equalTo: motionSlider.leadingAnchor),
+            entropySlider.trailingAnchor.constraint(equalTo: motionSlider.trailingAnchor),
+            
+            subscriberGridContainer.topAnchor.constraint(equalTo: entropyLabel.bottomAnchor, constant: 10),
+            subscriberGridContainer.leadingAnchor.constraint(equalTo: containerView.leadingAnchor, constant: 20),
+            subscriberGridContainer.trailingAnchor.constraint(equalTo: containerView.trailingAnchor, constant: -20),
+            subscriberGridContainer.heightAnchor.constraint(equalToConstant: 44),
+            
+            abTestContainer.topAnchor.constraint(equalTo: subscriberGridContainer.bottomAnchor, constant: 20),
+            abTestContainer.leadingAnchor.constraint(equalTo: containerView.leadingAnchor, constant: 20),
+            abTestContainer.trailingAnchor.constraint(equalTo: containerView.trailingAnchor, constant: -20),
+            abTestContainer.heightAnchor.constraint(equalToConstant: 44),
+            
+            windowLengthTextField.topAnchor.constraint(equalTo: abTestContainer.bottomAnchor, constant: 10),
+            windowLengthTextField.leadingAnchor.constraint(equalTo: containerView.leadingAnchor, constant: 20),
+            windowLengthTextField.trailingAnchor.constraint(equalTo: containerView.trailingAnchor, constant: -20),
+            windowLengthTextField.heightAnchor.constraint(equalToConstant: 44),
+            
+            repeatCountTextField.topAnchor.constraint(equalTo: windowLengthTextField.bottomAnchor, constant: 10),
+            repeatCountTextField.leadingAnchor.constraint(equalTo: containerView.leadingAnchor, constant: 20),
+            repeatCountTextField.trailingAnchor.constraint(equalTo: containerView.trailingAnchor, constant: -20),
+            repeatCountTextField.heightAnchor.constraint(equalToConstant: 44),
+            repeatCountTextField.bottomAnchor.constraint(equalTo: containerView.bottomAnchor, constant: -20),
             
             toggleLabel.leadingAnchor.constraint(equalTo: toggleContainer.leadingAnchor, constant: 16),
             toggleLabel.centerYAnchor.constraint(equalTo: toggleContainer.centerYAnchor),
@@ -145,6 +325,24 @@ class HomeViewController: UIViewController {
             qualityToggle.trailingAnchor.constraint(equalTo: toggleContainer.trailingAnchor, constant: -16),
             qualityToggle.centerYAnchor.constraint(equalTo: toggleContainer.centerYAnchor),
             
+            syntheticVideoLabel.leadingAnchor.constraint(equalTo: syntheticVideoContainer.leadingAnchor, constant: 16),
+            syntheticVideoLabel.centerYAnchor.constraint(equalTo: syntheticVideoContainer.centerYAnchor),
+            
+            syntheticVideoToggle.trailingAnchor.constraint(equalTo: syntheticVideoContainer.trailingAnchor, constant: -16),
+            syntheticVideoToggle.centerYAnchor.constraint(equalTo: syntheticVideoContainer.centerYAnchor),
+            
+            subscriberGridLabel.leadingAnchor.constraint(equalTo: subscriberGridContainer.leadingAnchor, constant: 16),
+            subscriberGridLabel.centerYAnchor.constraint(equalTo: subscriberGridContainer.centerYAnchor),
+            
+            subscriberGridToggle.trailingAnchor.constraint(equalTo: subscriberGridContainer.trailingAnchor, constant: -16),
+            subscriberGridToggle.centerYAnchor.constraint(equalTo: subscriberGridContainer.centerYAnchor),
+            
+            abTestLabel.leadingAnchor.constraint(equalTo: abTestContainer.leadingAnchor, constant: 16),
+            abTestLabel.centerYAnchor.constraint(equalTo: abTestContainer.centerYAnchor),
+            
+            abTestToggle.trailingAnchor.constraint(equalTo: abTestContainer.trailingAnchor, constant: -16),
+            abTestToggle.centerYAnchor.constraint(equalTo: abTestContainer.centerYAnchor),
+            
             startButton.centerXAnchor.constraint(equalTo: view.centerXAnchor),
             startButton.topAnchor.constraint(equalTo: containerView.bottomAnchor, constant: 30),
             startButton.widthAnchor.constraint(equalToConstant: 250),
@@ -156,6 +354,11 @@ class HomeViewController: UIViewController {
         startButton.addTarget(self, action: #selector(startButtonTapped), for: .touchUpInside)
         msisdnTextField.addTarget(self, action: #selector(msisdnTextFieldChanged), for: .editingChanged)
         qualityToggle.addTarget(self, action: #selector(qualityToggleChanged), for: .valueChanged)
+        syntheticVideoToggle.addTarget(self, action: #selector(syntheticVideoToggleChanged), for: .valueChanged)
+        motionSlider.addTarget(self, action: #selector(patternSliderChanged), for: .valueChanged)
+        entropySlider.addTarget(self, action: #selector(patternSliderChanged), for: .valueChanged)
+        subscriberGridToggle.addTarget(self, action: #selector(subscriberGridToggleChanged), for: .valueChanged)
+        abTestToggle.addTarget(self, action: #selector(abTestToggleChanged), for: .valueChanged)
     }
     
     // MARK: - Actions
@@ -167,13 +370,67 @@ class HomeViewController: UIViewController {
         isHighQuality = qualityToggle.isOn
     }
     
+    @objc private func syntheticVideoToggleChanged() {
+        isSyntheticVideoEnabled = syntheticVideoToggle.isOn
+        motionSlider.isEnabled = isSyntheticVideoEnabled
+        entropySlider.isEnabled = isSyntheticVideoEnabled
+    }
+    
+    @objc private func patternSliderChanged() {
+        motionLabel.text = String(format: "Motion %.2f", motionSlider.value)
+        entropyLabel.text = String(format: "Entropy %.2f", entropySlider.value)
+    }
+    
+    @objc private func subscriberGridToggleChanged() {
+        isSubscriberGridEnabled = subscriberGridToggle.isOn
+    }
+    
+    @objc private func abTestToggleChanged() {
+        isABTestEnabled = abTestToggle.isOn
+        windowLengthTextField.isEnabled = isABTestEnabled
+        repeatCountTextField.isEnabled = isABTestEnabled
+    }
+    
+    private func makeABTestConfiguration() -> ABTestConfiguration? {
+        guard isABTestEnabled else { return nil }
+        
+        var configuration = ABTestConfiguration()
+        if let windowLength = TimeInterval(windowLengthTextField.text ?? ""), windowLength > 0 {
+            configuration.baselineDuration = windowLength
+            configuration.qodDuration = windowLength
+        }
+        if let repeatCount = Int(repeatCountTextField.text ?? ""), repeatCount > 0 {
+            configuration.repeatCount = repeatCount
+        }
+        return configuration
+    }
+    
+    private func makeSyntheticVideoConfiguration() -> SyntheticPattern.Configuration? {
+        guard isSyntheticVideoEnabled else { return nil }
+        
+        var configuration = SyntheticPattern.Configuration()
+        configuration.motion = Double(motionSlider.value)
+        configuration.entropy = Double(entropySlider.value)
+        return configuration
+    }
+    
     @objc private func startButtonTapped() {
+        let abTestConfiguration = makeABTestConfiguration()
+        let syntheticVideo = makeSyntheticVideoConfiguration()
+        
         print("Form submitted with values:")
         print("MSISDN: \(msisdn)")
         print("1080p enabled: \(isHighQuality)")
+        print("Synthetic video: \(syntheticVideo.map { "motion \($0.motion), entropy \($0.entropy)" } ?? "off")")
+        print("Subscriber grid: \(isSubscriberGridEnabled)")
+        print("A/B test: \(abTestConfiguration.map { "\($0.repeatCount) x \(Int($0.baselineDuration))s" } ?? "off")")
         
         // Create QoDTestViewController with MSISDN and video quality settings
-        let viewController = QoDTestViewController(msisdn: msisdn, isHighQuality: isHighQuality)
+        let viewController = QoDTestViewController(msisdn: msisdn,
+                                                   isHighQuality: isHighQuality,
+                                                   syntheticVideo: syntheticVideo,
+                                                   usesSubscriberGrid: isSubscriberGridEnabled,
+                                                   abTestConfiguration: abTestConfiguration)
         navigationController?.pushViewController(viewController, animated: true)
     }
 }
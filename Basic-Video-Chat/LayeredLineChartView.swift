@@ -0,0 +1,275 @@
+//
+//  LayeredLineChartView.swift
+//  Basic-Video-Chat
+//
+//  LineChartView that splits drawing into two cached layers:
+//
+//  - a static layer with grid, axes, limit lines, data and legend, and
+//  - an overlay with highlights and markers.
+//
+//  Both layers draw asynchronously, so their recorded drawing commands are
+//  rasterized by Core Animation off the main thread and the result is kept
+//  as the layer's bitmap. A highlight change only redraws the overlay.
+//  While the viewport is moving, the static bitmap is scaled and translated
+//  to match, and a sharp re-render is scheduled once the movement settles.
+//
+//  animateReveal(duration:) replaces animate(xAxisDuration:) for large data:
+//  the data is rendered once and uncovered by an animated mask, so the
+//  animation costs the same at any point count.
+//
+
+import UIKit
+import DGCharts
+
+class LayeredLineChartView: LineChartView {
+    /// How long the viewport has to stay still before the static layer is re-rendered
+    var sharpRenderDelay: TimeInterval = 0.12
+
+    private let staticLayer = CALayer()
+    private let overlayLayer = CALayer()
+    private var layerDelegates: [LayerDrawingDelegate] = []
+
+    // Value-to-pixel matrix the static bitmap was rendered with, nil until the first render
+    private var renderedMatrix: CGAffineTransform?
+    private var isStaticLayerDirty = true
+    private var isDrawingStaticLayer = false
+    private var isUpdatingHighlight = false
+    private var pendingSharpRender: DispatchWorkItem?
+    private var isShowingNoDataText = false
+
+    override init(frame: CGRect) {
+        super.init(frame: frame)
+        setupLayers()
+    }
+
+    required init?(coder aDecoder: NSCoder) {
+        super.init(coder: aDecoder)
+        setupLayers()
+    }
+
+    deinit {
+        pendingSharpRender?.cancel()
+    }
+
+    private func setupLayers() {
+        let staticDelegate = LayerDrawingDelegate { chart, context in chart.drawStaticLayer(in: context) }
+        let overlayDelegate = LayerDrawingDelegate { chart, context in chart.drawOverlayLayer(in: context) }
+        staticDelegate.chart = self
+        overlayDelegate.chart = self
+        layerDelegates = [staticDelegate, overlayDelegate]
+
+        for (sublayer, delegate) in [(staticLayer, staticDelegate), (overlayLayer, overlayDelegate)] {
+            sublayer.delegate = delegate
+            sublayer.drawsAsynchronously = true
+            sublayer.contentsScale = UIScreen.main.scale
+            sublayer.needsDisplayOnBoundsChange = true
+            layer.addSublayer(sublayer)
+        }
+    }
+
+    override func layoutSubviews() {
+        super.layoutSubviews()
+
+        CATransaction.begin()
+        CATransaction.setDisableActions(true)
+        for sublayer in [staticLayer, overlayLayer] {
+            sublayer.bounds = CGRect(origin: .zero, size: bounds.size)
+            sublayer.position = CGPoint(x: bounds.midX, y: bounds.midY)
+        }
+        CATransaction.commit()
+    }
+
+    // MARK: - Invalidation
+
+    override func setNeedsDisplay() {
+        // The view itself only draws the "no data" text
+        if data == nil || isShowingNoDataText {
+            super.setNeedsDisplay()
+        }
+        guard !isDrawingStaticLayer else { return }
+
+        overlayLayer.setNeedsDisplay()
+        if !isUpdatingHighlight {
+            invalidateStaticLayer()
+        }
+    }
+
+    override func notifyDataSetChanged() {
+        isStaticLayerDirty = true
+        super.notifyDataSetChanged()
+    }
+
+    override func highlightValue(_ highlight: Highlight?, callDelegate: Bool) {
+        isUpdatingHighlight = true
+        defer { isUpdatingHighlight = false }
+        super.highlightValue(highlight, callDelegate: callDelegate)
+    }
+
+    override func highlightValues(_ highs: [Highlight]?) {
+        isUpdatingHighlight = true
+        defer { isUpdatingHighlight = false }
+        super.highlightValues(highs)
+    }
+
+    private func invalidateStaticLayer() {
+        let currentMatrix = getTransformer(forAxis: .left).valueToPixelMatrix
+        guard data != nil, !isStaticLayerDirty,
+              let renderedMatrix = renderedMatrix, renderedMatrix != currentMatrix else {
+            pendingSharpRender?.cancel()
+            staticLayer.setNeedsDisplay()
+            return
+        }
+
+        // Only the viewport moved: map the cached bitmap onto the new viewport for now
+        let center = CGPoint(x: bounds.midX, y: bounds.midY)
+        let mapping = renderedMatrix.inverted().concatenating(currentMatrix)
+        CATransaction.begin()
+        CATransaction.setDisableActions(true)
+        // Layer transforms apply around the center, so conjugate the mapping with it
+        staticLayer.setAffineTransform(CGAffineTransform(translationX: center.x, y: center.y)
+            .concatenating(mapping)
+            .concatenating(CGAffineTransform(translationX: -center.x, y: -center.y)))
+        CATransaction.commit()
+
+        pendingSharpRender?.cancel()
+        let sharpRender = DispatchWorkItem { [weak self] in
+            self?.staticLayer.setNeedsDisplay()
+        }
+        pendingSharpRender = sharpRender
+        DispatchQueue.main.asyncAfter(deadline: .now() + sharpRenderDelay, execute: sharpRender)
+    }
+
+    // MARK: - Animation
+
+    /// Uncovers the data area left to right over `duration`. Axes, labels and legend stay visible.
+    func animateReveal(duration: TimeInterval,
+                       timingFunction: CAMediaTimingFunction = CAMediaTimingFunction(name: .linear)) {
+        layoutIfNeeded()
+        let contentRect = viewPortHandler.contentRect
+        guard duration > 0, !contentRect.isEmpty else { return }
+
+        // Everything outside the content rect is always shown
+        let surroundings = CAShapeLayer()
+        let surroundingsPath = CGMutablePath()
+        surroundingsPath.addRect(staticLayer.bounds)
+        surroundingsPath.addRect(contentRect)
+        surroundings.frame = staticLayer.bounds
+        surroundings.path = surroundingsPath
+        surroundings.fillRule = .evenOdd
+        surroundings.fillColor = UIColor.black.cgColor
+
+        // Grows from the left edge of the content rect
+        let reveal = CALayer()
+        reveal.backgroundColor = UIColor.black.cgColor
+        reveal.anchorPoint = CGPoint(x: 0, y: 0.5)
+        reveal.bounds = CGRect(origin: .zero, size: contentRect.size)
+        reveal.position = CGPoint(x: contentRect.minX, y: contentRect.midY)
+
+        let mask = CALayer()
+        mask.frame = staticLayer.bounds
+        mask.addSublayer(surroundings)
+        mask.addSublayer(reveal)
+
+        let animation = CABasicAnimation(keyPath: "bounds.size.width")
+        animation.fromValue = 0
+        animation.toValue = contentRect.width
+        animation.duration = duration
+        animation.timingFunction = timingFunction
+
+        CATransaction.begin()
+        CATransaction.setCompletionBlock { [weak self] in
+            guard let self = self, self.staticLayer.mask === mask else { return }
+            self.staticLayer.mask = nil
+        }
+        reveal.add(animation, forKey: "reveal")
+        staticLayer.mask = mask
+        CATransaction.commit()
+    }
+
+    // MARK: - Drawing
+
+    override func draw(_ rect: CGRect) {
+        // With data, everything is drawn by the sublayers
+        isShowingNoDataText = data == nil
+        if isShowingNoDataText {
+            super.draw(rect)
+        }
+    }
+
+    override func valuesToHighlight() -> Bool {
+        return !isDrawingStaticLayer && super.valuesToHighlight()
+    }
+
+    fileprivate func drawStaticLayer(in context: CGContext) {
+        guard data != nil else { return }
+
+        UIGraphicsPushContext(context)
+        isDrawingStaticLayer = true
+        let drawsMarkers = drawMarkers
+        drawMarkers = false
+        super.draw(bounds)
+        drawMarkers = drawsMarkers
+        isDrawingStaticLayer = false
+        UIGraphicsPopContext()
+
+        renderedMatrix = getTransformer(forAxis: .left).valueToPixelMatrix
+        isStaticLayerDirty = false
+
+        // The new bitmap replaces the scaled one in the same transaction
+        CATransaction.begin()
+        CATransaction.setDisableActions(true)
+        staticLayer.setAffineTransform(.identity)
+        CATransaction.commit()
+    }
+
+    fileprivate func drawOverlayLayer(in context: CGContext) {
+        guard let data = data, let renderer = renderer, valuesToHighlight() else { return }
+
+        UIGraphicsPushContext(context)
+        defer { UIGraphicsPopContext() }
+
+        context.saveGState()
+        if clipDataToContentEnabled {
+            context.clip(to: viewPortHandler.contentRect)
+        }
+        renderer.drawHighlighted(context: context, indices: highlighted)
+        context.restoreGState()
+
+        // Same rules as ChartViewBase's marker drawing, which isn't reachable from here
+        guard let marker = marker, isDrawMarkersEnabled else { return }
+        for highlight in highlighted {
+            guard data.indices.contains(highlight.dataSetIndex),
+                  let entry = data.entry(for: highlight) else { continue }
+            let set = data[highlight.dataSetIndex]
+
+            let entryIndex = set.entryIndex(entry: entry)
+            guard entryIndex <= Int(Double(set.entryCount) * chartAnimator.phaseX) else { continue }
+
+            let position = getMarkerPosition(highlight: highlight)
+            guard viewPortHandler.isInBounds(x: position.x, y: position.y) else { continue }
+
+            marker.refreshContent(entry: entry, highlight: highlight)
+            marker.draw(context: context, point: position)
+        }
+    }
+}
+
+/// Draws a chart sublayer through the chart without making the view another layer's delegate.
+private final class LayerDrawingDelegate: NSObject, CALayerDelegate {
+    weak var chart: LayeredLineChartView?
+    private let drawing: (LayeredLineChartView, CGContext) -> Void
+
+    init(drawing: @escaping (LayeredLineChartView, CGContext) -> Void) {
+        self.drawing = drawing
+    }
+
+    func draw(_ layer: CALayer, in ctx: CGContext) {
+        guard let chart = chart else { return }
+        drawing(chart, ctx)
+    }
+
+    // Swap bitmaps and transforms without implicit animations
+    func action(for layer: CALayer, forKey event: String) -> CAAction? {
+        return NSNull()
+    }
+}
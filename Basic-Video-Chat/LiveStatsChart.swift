@@ -0,0 +1,145 @@
+//
+//  LiveStatsChart.swift
+//  Basic-Video-Chat
+//
+//  Scrolling bitrate / packet loss chart for the test screen. Samples are
+//  queued as they arrive and flushed into the chart at most once per display
+//  refresh, so chart work never competes with the video views for frames.
+//
+
+import UIKit
+import DGCharts
+
+class LiveStatsChart: NSObject {
+    /// Seconds of history kept on screen
+    var windowDuration: TimeInterval = 60
+
+    let chartView: LineChartView = {
+        let chartView = LineChartView()
+        chartView.xAxis.labelPosition = .bottom
+        chartView.xAxis.valueFormatter = DateValueFormatter()
+        chartView.xAxis.labelCount = 3
+        chartView.leftAxis.axisMinimum = 0
+        chartView.rightAxis.axisMinimum = 0
+        chartView.rightAxis.axisMaximum = 1
+        chartView.chartDescription.enabled = false
+        // Read-only: no gestures, highlights or markers to process while the call runs
+        chartView.isUserInteractionEnabled = false
+        chartView.highlightPerTapEnabled = false
+        chartView.layer.drawsAsynchronously = true
+        return chartView
+    }()
+
+    private let bitrateDataSet: ContiguousLineChartDataSet = {
+        let dataSet = ContiguousLineChartDataSet(label: "Bitrate (Kbps)")
+        dataSet.drawCirclesEnabled = false
+        dataSet.drawValuesEnabled = false
+        dataSet.isLookupTableEnabled = true
+        dataSet.lineWidth = 2
+        dataSet.setColor(.systemBlue)
+        dataSet.axisDependency = .left
+        return dataSet
+    }()
+
+    private let packetLossDataSet: ContiguousLineChartDataSet = {
+        let dataSet = ContiguousLineChartDataSet(label: "Packet Loss")
+        dataSet.drawCirclesEnabled = false
+        dataSet.drawValuesEnabled = false
+        dataSet.isLookupTableEnabled = true
+        dataSet.lineWidth = 1
+        dataSet.setColor(.systemOrange)
+        dataSet.axisDependency = .right
+        return dataSet
+    }()
+
+    private var pendingStats: [VideoStats] = []
+    private var lastQoDEnabled: Bool?
+    private var displayLink: CADisplayLink?
+
+    override init() {
+        super.init()
+        chartView.renderer = ContiguousLineChartRenderer(chartView: chartView)
+        chartView.data = LineChartData(dataSets: [bitrateDataSet, packetLossDataSet])
+    }
+
+    deinit {
+        displayLink?.invalidate()
+    }
+
+    /// Queues a sample; it is drawn on the next display refresh.
+    func append(_ stats: VideoStats) {
+        pendingStats.append(stats)
+        if displayLink == nil {
+            let link = CADisplayLink(target: WeakDisplayLinkTarget(self), selector: #selector(WeakDisplayLinkTarget.tick))
+            link.add(to: .main, forMode: .common)
+            displayLink = link
+        }
+        displayLink?.isPaused = false
+    }
+
+    func stop() {
+        displayLink?.invalidate()
+        displayLink = nil
+        pendingStats.removeAll()
+    }
+
+    fileprivate func flush() {
+        // Nothing new since the last frame: stop ticking until the next sample
+        guard !pendingStats.isEmpty, let data = chartView.data else {
+            displayLink?.isPaused = true
+            return
+        }
+
+        for stats in pendingStats {
+            let x = stats.timestamp / 1000
+            bitrateDataSet.append(x: x, y: stats.videoBitrateKbps)
+            packetLossDataSet.append(x: x, y: stats.packetLossRatio)
+
+            if let last = lastQoDEnabled, last != stats.qodEnabled {
+                let limitLine = ChartLimitLine(limit: x, label: stats.qodEnabled ? "QoD on" : "QoD off")
+                limitLine.lineWidth = 1
+                limitLine.lineColor = stats.qodEnabled ? .systemRed : .systemGray
+                limitLine.valueFont = .systemFont(ofSize: 9)
+                chartView.xAxis.addLimitLine(limitLine)
+            }
+            lastQoDEnabled = stats.qodEnabled
+        }
+        pendingStats.removeAll(keepingCapacity: true)
+
+        // Slide the window: drop everything older than windowDuration in one batch per data set
+        guard let newest = bitrateDataSet.xValues.last else { return }
+        let oldest = newest - windowDuration
+        [bitrateDataSet, packetLossDataSet].forEach { dataSet in
+            let expired = dataSet.lowerBound(x: oldest)
+            if expired > 0 {
+                dataSet.removeFirst(count: expired)
+            }
+        }
+        chartView.xAxis.limitLines
+            .filter { $0.limit < oldest }
+            .forEach { chartView.xAxis.removeLimitLine($0) }
+
+        chartView.xAxis.axisMinimum = oldest
+        chartView.xAxis.axisMaximum = newest
+
+        data.notifyDataChanged()
+        chartView.notifyDataSetChanged()
+    }
+}
+
+/// CADisplayLink retains its target; this breaks the cycle with the chart.
+private class WeakDisplayLinkTarget: NSObject {
+    private weak var chart: LiveStatsChart?
+
+    init(_ chart: LiveStatsChart) {
+        self.chart = chart
+    }
+
+    @objc func tick(_ link: CADisplayLink) {
+        guard let chart = chart else {
+            link.invalidate()
+            return
+        }
+        chart.flush()
+    }
+}
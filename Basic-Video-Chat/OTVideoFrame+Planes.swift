@@ -0,0 +1,75 @@
+//
+//  OTVideoFrame+Planes.swift
+//  Basic-Video-Chat
+//
+//  Typed plane views of an OTVideoFrame for the conversion and transform
+//  kernels, the rotation that turns a frame upright, and PlaneBufferPool
+//  lookups by OTVideoFormat.
+//
+
+import OpenTok
+
+extension OTVideoFrame {
+    var width: Int { return Int(format?.imageWidth ?? 0) }
+    var height: Int { return Int(format?.imageHeight ?? 0) }
+
+    /// The frame's planes, nil unless it is I420
+    var i420Planes: I420Planes? {
+        guard format?.pixelFormat == .I420, (planes?.count ?? 0) >= 3 else { return nil }
+        return I420Planes(y: getPlaneBinaryData(0), yStride: Int(getPlaneStride(0)),
+                          u: getPlaneBinaryData(1), uStride: Int(getPlaneStride(1)),
+                          v: getPlaneBinaryData(2), vStride: Int(getPlaneStride(2)))
+    }
+
+    /// The frame's planes, nil unless it is NV12
+    var nv12Planes: NV12Planes? {
+        guard format?.pixelFormat == .NV12, (planes?.count ?? 0) >= 2 else { return nil }
+        return NV12Planes(y: getPlaneBinaryData(0), yStride: Int(getPlaneStride(0)),
+                          uv: getPlaneBinaryData(1), uvStride: Int(getPlaneStride(1)))
+    }
+
+    /// The frame's pixels, nil unless it is ARGB
+    var argbPlane: ARGBPlane? {
+        guard format?.pixelFormat == .ARGB, (planes?.count ?? 0) >= 1 else { return nil }
+        return ARGBPlane(pixels: getPlaneBinaryData(0), stride: Int(getPlaneStride(0)))
+    }
+}
+
+extension PlaneRotation {
+    /// Rotation that undoes `orientation`, using WebRTC's mapping of Left to 90 and Right to 270 degrees.
+    init(uprighting orientation: OTVideoOrientation) {
+        switch orientation {
+        case .left: self = .clockwise90
+        case .down: self = .clockwise180
+        case .right: self = .clockwise270
+        default: self = .none
+        }
+    }
+}
+
+extension PlaneBufferLayout {
+    /// Layout of frames described by `format`, nil when it has no size.
+    init?(format: OTVideoFormat) {
+        let pixelFormat: PixelFormat
+        switch format.pixelFormat {
+        case .I420: pixelFormat = .i420
+        case .NV12: pixelFormat = .nv12
+        case .ARGB: pixelFormat = .argb
+        @unknown default: return nil
+        }
+        guard format.imageWidth > 0, format.imageHeight > 0 else { return nil }
+        self.init(width: Int(format.imageWidth), height: Int(format.imageHeight), pixelFormat: pixelFormat)
+    }
+
+    /// Gives `format` this layout's row strides, which are wider than the packed ones it starts with.
+    func applyStrides(to format: OTVideoFormat) {
+        format.bytesPerRow = NSMutableArray(array: (0 ..< planeCount).map { stride(ofPlane: $0) })
+    }
+}
+
+extension PlaneBufferPool {
+    /// The shared pool for frames in `format`, nil when it has no size.
+    static func shared(for format: OTVideoFormat) -> PlaneBufferPool? {
+        return PlaneBufferLayout(format: format).map { shared(for: $0) }
+    }
+}
@@ -0,0 +1,345 @@
+//
+//  PixelFormatConversion.swift
+//  Basic-Video-Chat
+//
+//  Conversions between the three OTPixelFormat layouts for custom capture
+//  and render code, since OTVideoFrame.convertInPlace is opaque:
+//
+//  - I420: Y plane, then quarter-size U and V planes
+//  - NV12: Y plane, then one quarter-size plane of interleaved U, V pairs
+//  - ARGB: 32-bit pixels, A R G B from the most significant byte, so B, G,
+//    R, A in memory (libyuv's and WebRTC's ARGB)
+//
+//  YUV is BT.601 limited range. All planes are stride-aware and caller
+//  owned; nothing here allocates. The inner loops work on 8 pixels at a
+//  time with SIMD vectors, which the compiler lowers to NEON or SSE, and
+//  finish rows with a scalar tail. Like the rest of the app this assumes a
+//  little-endian CPU. Only Foundation is used, so the kernels build and can
+//  be timed anywhere Swift runs.
+//
+
+import Foundation
+
+/// Caller-owned I420 planes. Chroma planes are half the luma size in both directions, rounded up.
+struct I420Planes {
+    var y: UnsafeMutablePointer<UInt8>
+    var yStride: Int
+    var u: UnsafeMutablePointer<UInt8>
+    var uStride: Int
+    var v: UnsafeMutablePointer<UInt8>
+    var vStride: Int
+}
+
+/// Caller-owned NV12 planes; `uv` holds one U, V byte pair per 2x2 block of luma.
+struct NV12Planes {
+    var y: UnsafeMutablePointer<UInt8>
+    var yStride: Int
+    var uv: UnsafeMutablePointer<UInt8>
+    var uvStride: Int
+}
+
+/// A caller-owned ARGB plane, four bytes per pixel.
+struct ARGBPlane {
+    var pixels: UnsafeMutablePointer<UInt8>
+    var stride: Int
+}
+
+enum PixelFormatConversion {
+    // MARK: - I420 <-> NV12
+
+    static func convert(_ source: I420Planes, to destination: NV12Planes, width: Int, height: Int) {
+        copyPlane(source.y, stride: source.yStride, to: destination.y, stride: destination.yStride,
+                  rowBytes: width, rows: height)
+        for row in 0 ..< chromaSize(height) {
+            interleave(u: source.u + row * source.uStride,
+                       v: source.v + row * source.vStride,
+                       into: destination.uv + row * destination.uvStride,
+                       count: chromaSize(width))
+        }
+    }
+
+    static func convert(_ source: NV12Planes, to destination: I420Planes, width: Int, height: Int) {
+        copyPlane(source.y, stride: source.yStride, to: destination.y, stride: destination.yStride,
+                  rowBytes: width, rows: height)
+        for row in 0 ..< chromaSize(height) {
+            deinterleave(source.uv + row * source.uvStride,
+                         u: destination.u + row * destination.uStride,
+                         v: destination.v + row * destination.vStride,
+                         count: chromaSize(width))
+        }
+    }
+
+    // MARK: - YUV -> ARGB
+
+    static func convert(_ source: I420Planes, to destination: ARGBPlane, width: Int, height: Int) {
+        for row in 0 ..< height {
+            let yRow = source.y + row * source.yStride
+            let uRow = source.u + (row / 2) * source.uStride
+            let vRow = source.v + (row / 2) * source.vStride
+            let out = destination.pixels + row * destination.stride
+
+            var x = 0
+            while x + 8 <= width {
+                let u: SIMD4<UInt8> = loadVector(uRow + x / 2)
+                let v: SIMD4<UInt8> = loadVector(vRow + x / 2)
+                storeVector(argbPixels(y: loadVector(yRow + x), u: duplicated(u), v: duplicated(v)), to: out + 4 * x)
+                x += 8
+            }
+            while x < width {
+                storeVector(argbPixel(y: yRow[x], u: uRow[x / 2], v: vRow[x / 2]), to: out + 4 * x)
+                x += 1
+            }
+        }
+    }
+
+    static func convert(_ source: NV12Planes, to destination: ARGBPlane, width: Int, height: Int) {
+        for row in 0 ..< height {
+            let yRow = source.y + row * source.yStride
+            let uvRow = source.uv + (row / 2) * source.uvStride
+            let out = destination.pixels + row * destination.stride
+
+            var x = 0
+            while x + 8 <= width {
+                // Four U, V pairs cover eight pixels; spread each byte of a pair over both its pixels
+                let pairs: SIMD4<UInt16> = loadVector(uvRow + x)
+                let u = unsafeBitCast((pairs & 0x00FF) | ((pairs & 0x00FF) &<< 8), to: SIMD8<UInt8>.self)
+                let v = unsafeBitCast((pairs &>> 8) | (pairs & 0xFF00), to: SIMD8<UInt8>.self)
+                storeVector(argbPixels(y: loadVector(yRow + x), u: u, v: v), to: out + 4 * x)
+                x += 8
+            }
+            while x < width {
+                let chroma = uvRow + (x / 2) * 2
+                storeVector(argbPixel(y: yRow[x], u: chroma[0], v: chroma[1]), to: out + 4 * x)
+                x += 1
+            }
+        }
+    }
+
+    // MARK: - ARGB -> YUV
+
+    static func convert(_ source: ARGBPlane, to destination: I420Planes, width: Int, height: Int) {
+        argbToYUV(source, width: width, height: height,
+                  y: destination.y, yStride: destination.yStride,
+                  chroma: .planar(u: destination.u, uStride: destination.uStride,
+                                  v: destination.v, vStride: destination.vStride))
+    }
+
+    static func convert(_ source: ARGBPlane, to destination: NV12Planes, width: Int, height: Int) {
+        argbToYUV(source, width: width, height: height,
+                  y: destination.y, yStride: destination.yStride,
+                  chroma: .interleaved(uv: destination.uv, uvStride: destination.uvStride))
+    }
+
+    // MARK: - Shared
+
+    /// Chroma plane width or height for a luma width or height
+    static func chromaSize(_ lumaSize: Int) -> Int {
+        return (lumaSize + 1) / 2
+    }
+
+    static func copyPlane(_ source: UnsafePointer<UInt8>, stride sourceStride: Int,
+                          to destination: UnsafeMutablePointer<UInt8>, stride destinationStride: Int,
+                          rowBytes: Int, rows: Int) {
+        if sourceStride == rowBytes && destinationStride == rowBytes {
+            destination.assign(from: source, count: rowBytes * rows)
+            return
+        }
+        for row in 0 ..< rows {
+            (destination + row * destinationStride).assign(from: source + row * sourceStride, count: rowBytes)
+        }
+    }
+
+    private enum ChromaDestination {
+        case planar(u: UnsafeMutablePointer<UInt8>, uStride: Int, v: UnsafeMutablePointer<UInt8>, vStride: Int)
+        case interleaved(uv: UnsafeMutablePointer<UInt8>, uvStride: Int)
+    }
+
+    private static func interleave(u: UnsafePointer<UInt8>, v: UnsafePointer<UInt8>,
+                                   into uv: UnsafeMutablePointer<UInt8>, count: Int) {
+        var i = 0
+        while i + 8 <= count {
+            // Widening puts U in the low byte of each 16-bit lane and V in the high one
+            let uLanes = SIMD8<UInt16>(truncatingIfNeeded: loadVector(u + i) as SIMD8<UInt8>)
+            let vLanes = SIMD8<UInt16>(truncatingIfNeeded: loadVector(v + i) as SIMD8<UInt8>)
+            storeVector(uLanes | (vLanes &<< 8), to: uv + 2 * i)
+            i += 8
+        }
+        while i < count {
+            uv[2 * i] = u[i]
+            uv[2 * i + 1] = v[i]
+            i += 1
+        }
+    }
+
+    private static func deinterleave(_ uv: UnsafePointer<UInt8>,
+                                     u: UnsafeMutablePointer<UInt8>, v: UnsafeMutablePointer<UInt8>, count: Int) {
+        var i = 0
+        while i + 8 <= count {
+            let pairs: SIMD8<UInt16> = loadVector(uv + 2 * i)
+            storeVector(SIMD8<UInt8>(truncatingIfNeeded: pairs), to: u + i)
+            storeVector(SIMD8<UInt8>(truncatingIfNeeded: pairs &>> 8), to: v + i)
+            i += 8
+        }
+        while i < count {
+            u[i] = uv[2 * i]
+            v[i] = uv[2 * i + 1]
+            i += 1
+        }
+    }
+
+    private static func argbToYUV(_ source: ARGBPlane, width: Int, height: Int,
+                                  y: UnsafeMutablePointer<UInt8>, yStride: Int, chroma: ChromaDestination) {
+        for row in 0 ..< height {
+            let pixels = source.pixels + row * source.stride
+            let out = y + row * yStride
+            var x = 0
+            while x + 8 <= width {
+                let (r, g, b) = channels(loadVector(pixels + 4 * x) as SIMD8<UInt32>)
+                storeVector(luma(r: r, g: g, b: b), to: out + x)
+                x += 8
+            }
+            while x < width {
+                let (r, g, b) = channels(SIMD8<UInt32>(repeating: loadPixel(pixels + 4 * x)))
+                out[x] = luma(r: r, g: g, b: b)[0]
+                x += 1
+            }
+        }
+
+        // Each chroma sample is taken from the average of its 2x2 block, edges repeat the last pixel
+        let chromaWidth = chromaSize(width)
+        for chromaRow in 0 ..< chromaSize(height) {
+            let row0 = source.pixels + (2 * chromaRow) * source.stride
+            let row1 = source.pixels + min(2 * chromaRow + 1, height - 1) * source.stride
+            var x = 0
+            while x + 8 <= width / 2 {
+                let top: SIMD16<UInt32> = loadVector(row0 + 8 * x)
+                let bottom: SIMD16<UInt32> = loadVector(row1 + 8 * x)
+                let (u, v) = chromaSamples(top.evenHalf, top.oddHalf, bottom.evenHalf, bottom.oddHalf)
+                storeChroma(u: u, v: v, at: x, row: chromaRow, into: chroma)
+                x += 8
+            }
+            while x < chromaWidth {
+                let right = min(2 * x + 1, width - 1)
+                let pick: (UnsafeMutablePointer<UInt8>, Int) -> SIMD8<UInt32> = { row, column in
+                    SIMD8<UInt32>(repeating: loadPixel(row + 4 * column))
+                }
+                let (u, v) = chromaSamples(pick(row0, 2 * x), pick(row0, right), pick(row1, 2 * x), pick(row1, right))
+                switch chroma {
+                case let .planar(uPlane, uStride, vPlane, vStride):
+                    uPlane[chromaRow * uStride + x] = u[0]
+                    vPlane[chromaRow * vStride + x] = v[0]
+                case let .interleaved(uv, uvStride):
+                    uv[chromaRow * uvStride + 2 * x] = u[0]
+                    uv[chromaRow * uvStride + 2 * x + 1] = v[0]
+                }
+                x += 1
+            }
+        }
+    }
+
+    private static func storeChroma(u: SIMD8<UInt8>, v: SIMD8<UInt8>, at x: Int, row: Int, into chroma: ChromaDestination) {
+        switch chroma {
+        case let .planar(uPlane, uStride, vPlane, vStride):
+            storeVector(u, to: uPlane + row * uStride + x)
+            storeVector(v, to: vPlane + row * vStride + x)
+        case let .interleaved(uv, uvStride):
+            let pairs = SIMD8<UInt16>(truncatingIfNeeded: u) | (SIMD8<UInt16>(truncatingIfNeeded: v) &<< 8)
+            storeVector(pairs, to: uv + row * uvStride + 2 * x)
+        }
+    }
+
+    // MARK: - Pixel math
+
+    @inline(__always)
+    private static func argbPixels(y: SIMD8<UInt8>, u: SIMD8<UInt8>, v: SIMD8<UInt8>) -> SIMD8<UInt32> {
+        let c = (SIMD8<Int32>(truncatingIfNeeded: y) &- 16) &* 298 &+ 128
+        let d = SIMD8<Int32>(truncatingIfNeeded: u) &- 128
+        let e = SIMD8<Int32>(truncatingIfNeeded: v) &- 128
+        let r = clampedByte((c &+ e &* 409) &>> 8)
+        let g = clampedByte((c &- d &* 100 &- e &* 208) &>> 8)
+        let b = clampedByte((c &+ d &* 516) &>> 8)
+        return (r &<< 16) | (g &<< 8) | b | 0xFF00_0000
+    }
+
+    @inline(__always)
+    private static func argbPixel(y: UInt8, u: UInt8, v: UInt8) -> UInt32 {
+        return argbPixels(y: SIMD8(repeating: y), u: SIMD8(repeating: u), v: SIMD8(repeating: v))[0]
+    }
+
+    @inline(__always)
+    private static func channels(_ pixels: SIMD8<UInt32>) -> (r: SIMD8<Int32>, g: SIMD8<Int32>, b: SIMD8<Int32>) {
+        return (SIMD8<Int32>(truncatingIfNeeded: (pixels &>> 16) & 0xFF),
+                SIMD8<Int32>(truncatingIfNeeded: (pixels &>> 8) & 0xFF),
+                SIMD8<Int32>(truncatingIfNeeded: pixels & 0xFF))
+    }
+
+    @inline(__always)
+    private static func luma(r: SIMD8<Int32>, g: SIMD8<Int32>, b: SIMD8<Int32>) -> SIMD8<UInt8> {
+        let y = ((r &* 66 &+ g &* 129 &+ b &* 25 &+ 128) &>> 8) &+ 16
+        return SIMD8<UInt8>(truncatingIfNeeded: y)
+    }
+
+    @inline(__always)
+    private static func chromaSamples(_ p0: SIMD8<UInt32>, _ p1: SIMD8<UInt32>,
+                                      _ p2: SIMD8<UInt32>, _ p3: SIMD8<UInt32>) -> (u: SIMD8<UInt8>, v: SIMD8<UInt8>) {
+        let c0 = channels(p0), c1 = channels(p1), c2 = channels(p2), c3 = channels(p3)
+        let r = (c0.r &+ c1.r &+ c2.r &+ c3.r &+ 2) &>> 2
+        let g = (c0.g &+ c1.g &+ c2.g &+ c3.g &+ 2) &>> 2
+        let b = (c0.b &+ c1.b &+ c2.b &+ c3.b &+ 2) &>> 2
+        let u = ((b &* 112 &- r &* 38 &- g &* 74 &+ 128) &>> 8) &+ 128
+        let v = ((r &* 112 &- g &* 94 &- b &* 18 &+ 128) &>> 8) &+ 128
+        return (SIMD8<UInt8>(truncatingIfNeeded: u), SIMD8<UInt8>(truncatingIfNeeded: v))
+    }
+
+    @inline(__always)
+    private static func clampedByte(_ value: SIMD8<Int32>) -> SIMD8<UInt32> {
+        let clamped = value.clamped(lowerBound: SIMD8(repeating: 0), upperBound: SIMD8(repeating: 255))
+        return SIMD8<UInt32>(truncatingIfNeeded: clamped)
+    }
+
+    @inline(__always)
+    private static func loadPixel(_ pointer: UnsafeMutablePointer<UInt8>) -> UInt32 {
+        var pixel: UInt32 = 0
+        withUnsafeMutableBytes(of: &pixel) { bytes in
+            bytes.copyMemory(from: UnsafeRawBufferPointer(start: pointer, count: 4))
+        }
+        return pixel
+    }
+
+    /// Repeats every chroma sample twice, one for each pixel it covers.
+    @inline(__always)
+    private static func duplicated(_ samples: SIMD4<UInt8>) -> SIMD8<UInt8> {
+        let lanes = SIMD4<UInt16>(truncatingIfNeeded: samples)
+        return unsafeBitCast(lanes | (lanes &<< 8), to: SIMD8<UInt8>.self)
+    }
+}
+
+// MARK: - Unaligned vector access
+
+/// Plane rows carry no alignment guarantee, so vectors are moved with memcpy-style copies,
+/// which compile to single unaligned loads and stores.
+@inline(__always)
+func loadVector<V: SIMD>(_ pointer: UnsafeRawPointer) -> V {
+    var vector = V()
+    withUnsafeMutableBytes(of: &vector) { bytes in
+        bytes.copyMemory(from: UnsafeRawBufferPointer(start: pointer, count: MemoryLayout<V>.size))
+    }
+    return vector
+}
+
+@inline(__always)
+func loadVector<V: SIMD>(_ pointer: UnsafeMutablePointer<UInt8>) -> V {
+    return loadVector(UnsafeRawPointer(pointer))
+}
+
+@inline(__always)
+func loadVector<V: SIMD>(_ pointer: UnsafePointer<UInt8>) -> V {
+    return loadVector(UnsafeRawPointer(pointer))
+}
+
+@inline(__always)
+func storeVector<V>(_ vector: V, to pointer: UnsafeMutablePointer<UInt8>) {
+    withUnsafeBytes(of: vector) { bytes in
+        UnsafeMutableRawPointer(pointer).copyMemory(from: bytes.baseAddress!, byteCount: MemoryLayout<V>.size)
+    }
+}
@@ -0,0 +1,39 @@
+//
+//  PlaneBufferAtomics.h
+//  Basic-Video-Chat
+//
+//  The few C11 atomic operations PlaneBufferPool needs, which Swift's
+//  standard library doesn't offer. They work on plain integers that Swift
+//  owns in stable, manually allocated memory, never on Swift properties.
+//
+
+#ifndef PlaneBufferAtomics_h
+#define PlaneBufferAtomics_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Sets a free (0) slot flag to 1. Acquire, so the previous holder's writes are visible.
+static inline bool PlaneBufferTryClaim(int32_t *flag) {
+    int32_t expected = 0;
+    return atomic_compare_exchange_strong_explicit((_Atomic int32_t *)flag, &expected, 1,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+/// Sets a slot flag back to 0 and returns its previous value. Release, so our writes are
+/// visible to the next holder.
+static inline int32_t PlaneBufferRelease(int32_t *flag) {
+    return atomic_exchange_explicit((_Atomic int32_t *)flag, 0, memory_order_release);
+}
+
+/// Adds one to a counter and returns its previous value. Relaxed: counters order nothing.
+static inline int64_t PlaneBufferIncrement(int64_t *counter) {
+    return atomic_fetch_add_explicit((_Atomic int64_t *)counter, 1, memory_order_relaxed);
+}
+
+static inline int64_t PlaneBufferLoad(int64_t *counter) {
+    return atomic_load_explicit((_Atomic int64_t *)counter, memory_order_relaxed);
+}
+
+#endif /* PlaneBufferAtomics_h */
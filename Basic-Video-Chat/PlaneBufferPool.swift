@@ -0,0 +1,218 @@
+//
+//  PlaneBufferPool.swift
+//  Basic-Video-Chat
+//
+//  Fixed-size pool of aligned plane buffers for one frame layout, so capture,
+//  render and transform paths can take a buffer per frame without a 3 MB
+//  allocation each time at 1080p. Buffers are allocated once when the pool is
+//  created. Acquiring claims a free slot with a compare-and-swap and
+//  releasing clears it, so producers and consumers on different threads
+//  never block each other. When every slot is taken, acquire falls back to a
+//  one-off heap buffer instead of waiting; the metrics count those as
+//  misses.
+//
+//  Pools are shared per layout through `shared(for:)`, which takes a lock
+//  only to find or create the pool. Callers should keep the pool they get.
+//  Shared pools live as long as the app, so they suit fixed layouts such as
+//  a capture format; code whose frame sizes come and go owns its pools.
+//
+
+import Foundation
+
+/// Size and plane arrangement of one frame. Strides and plane offsets are rounded up
+/// to `alignment` bytes so every row starts on a cache line and suits vector loads.
+struct PlaneBufferLayout: Hashable {
+    enum PixelFormat: Hashable {
+        case i420, nv12, argb
+    }
+
+    static let alignment = 64
+
+    let width: Int
+    let height: Int
+    let pixelFormat: PixelFormat
+
+    init(width: Int, height: Int, pixelFormat: PixelFormat) {
+        precondition(width > 0 && height > 0, "plane buffers need a non-empty frame")
+        self.width = width
+        self.height = height
+        self.pixelFormat = pixelFormat
+    }
+
+    var planeCount: Int {
+        switch pixelFormat {
+        case .i420: return 3
+        case .nv12: return 2
+        case .argb: return 1
+        }
+    }
+
+    var chromaWidth: Int { return (width + 1) / 2 }
+    var chromaHeight: Int { return (height + 1) / 2 }
+
+    func stride(ofPlane plane: Int) -> Int {
+        switch (pixelFormat, plane) {
+        case (.i420, 0), (.nv12, 0): return PlaneBufferLayout.aligned(width)
+        case (.i420, _): return PlaneBufferLayout.aligned(chromaWidth)
+        case (.nv12, _): return PlaneBufferLayout.aligned(chromaWidth * 2)
+        case (.argb, _): return PlaneBufferLayout.aligned(width * 4)
+        }
+    }
+
+    func rows(ofPlane plane: Int) -> Int {
+        return plane == 0 ? height : chromaHeight
+    }
+
+    func offset(ofPlane plane: Int) -> Int {
+        return (0 ..< plane).reduce(0) { $0 + stride(ofPlane: $1) * rows(ofPlane: $1) }
+    }
+
+    var byteCount: Int {
+        return offset(ofPlane: planeCount)
+    }
+
+    private static func aligned(_ value: Int) -> Int {
+        return (value + alignment - 1) / alignment * alignment
+    }
+}
+
+/// A buffer taken from a PlaneBufferPool. Hand it back with `release(_:)` on the same pool,
+/// from any thread, once nothing reads or writes it anymore.
+struct PlaneBuffer {
+    let layout: PlaneBufferLayout
+    let bytes: UnsafeMutableRawPointer
+    // Index of the pool slot, nil for a fallback allocation
+    fileprivate let slot: Int?
+
+    /// False for the one-off allocation acquire() falls back to when every slot is taken
+    var isPooled: Bool {
+        return slot != nil
+    }
+
+    func plane(_ plane: Int) -> UnsafeMutablePointer<UInt8> {
+        return (bytes + layout.offset(ofPlane: plane)).assumingMemoryBound(to: UInt8.self)
+    }
+
+    var i420Planes: I420Planes? {
+        guard layout.pixelFormat == .i420 else { return nil }
+        return I420Planes(y: plane(0), yStride: layout.stride(ofPlane: 0),
+                          u: plane(1), uStride: layout.stride(ofPlane: 1),
+                          v: plane(2), vStride: layout.stride(ofPlane: 2))
+    }
+
+    var nv12Planes: NV12Planes? {
+        guard layout.pixelFormat == .nv12 else { return nil }
+        return NV12Planes(y: plane(0), yStride: layout.stride(ofPlane: 0),
+                          uv: plane(1), uvStride: layout.stride(ofPlane: 1))
+    }
+
+    var argbPlane: ARGBPlane? {
+        guard layout.pixelFormat == .argb else { return nil }
+        return ARGBPlane(pixels: plane(0), stride: layout.stride(ofPlane: 0))
+    }
+}
+
+final class PlaneBufferPool {
+    struct Metrics {
+        var acquisitions: Int64
+        /// Acquisitions served from a pool slot
+        var hits: Int64
+        /// Buffers allocated in total: the pool's slots plus one per miss
+        var allocations: Int64
+
+        var misses: Int64 { return acquisitions - hits }
+        var hitRate: Double { return acquisitions > 0 ? Double(hits) / Double(acquisitions) : 1 }
+    }
+
+    static let defaultSlotCount = 6
+
+    let layout: PlaneBufferLayout
+    let slotCount: Int
+
+    private let storage: UnsafeMutableRawPointer
+    private let slotByteCount: Int
+    // One flag per slot, 1 while taken; only touched through PlaneBufferAtomics
+    private let flags: UnsafeMutablePointer<Int32>
+    // acquisitions, hits, fallback allocations, next slot to try
+    private let counters: UnsafeMutablePointer<Int64>
+
+    private static let registryLock = NSLock()
+    private static var registry: [PlaneBufferLayout: PlaneBufferPool] = [:]
+
+    init(layout: PlaneBufferLayout, slotCount: Int = PlaneBufferPool.defaultSlotCount) {
+        precondition(slotCount > 0, "a pool needs at least one slot")
+        self.layout = layout
+        self.slotCount = slotCount
+        slotByteCount = layout.byteCount
+        storage = UnsafeMutableRawPointer.allocate(byteCount: slotByteCount * slotCount,
+                                                   alignment: PlaneBufferLayout.alignment)
+        flags = UnsafeMutablePointer<Int32>.allocate(capacity: slotCount)
+        flags.initialize(repeating: 0, count: slotCount)
+        counters = UnsafeMutablePointer<Int64>.allocate(capacity: 4)
+        counters.initialize(repeating: 0, count: 4)
+    }
+
+    deinit {
+        flags.deallocate()
+        counters.deallocate()
+        storage.deallocate()
+    }
+
+    /// The pool shared by everyone using `layout`, created on first use.
+    static func shared(for layout: PlaneBufferLayout) -> PlaneBufferPool {
+        registryLock.lock()
+        defer { registryLock.unlock() }
+        if let pool = registry[layout] {
+            return pool
+        }
+        let pool = PlaneBufferPool(layout: layout)
+        registry[layout] = pool
+        return pool
+    }
+
+    /// Metrics of every shared pool.
+    static var sharedMetrics: [(layout: PlaneBufferLayout, metrics: Metrics)] {
+        registryLock.lock()
+        defer { registryLock.unlock() }
+        return registry.map { ($0.key, $0.value.metrics) }
+    }
+
+    /// A free buffer, or a newly allocated one when all slots are taken. Never blocks.
+    /// The contents are whatever the previous holder left there.
+    func acquire() -> PlaneBuffer {
+        _ = PlaneBufferIncrement(counters)
+        // Rotate the first slot tried, so concurrent callers spread over the slots
+        let start = Int(truncatingIfNeeded: PlaneBufferIncrement(counters + 3))
+        for step in 0 ..< slotCount {
+            let slot = (start &+ step) % slotCount
+            if PlaneBufferTryClaim(flags + slot) {
+                _ = PlaneBufferIncrement(counters + 1)
+                return PlaneBuffer(layout: layout, bytes: storage + slot * slotByteCount, slot: slot)
+            }
+        }
+
+        _ = PlaneBufferIncrement(counters + 2)
+        let bytes = UnsafeMutableRawPointer.allocate(byteCount: slotByteCount, alignment: PlaneBufferLayout.alignment)
+        return PlaneBuffer(layout: layout, bytes: bytes, slot: nil)
+    }
+
+    func release(_ buffer: PlaneBuffer) {
+        guard let slot = buffer.slot else {
+            buffer.bytes.deallocate()
+            return
+        }
+        precondition(buffer.layout == layout && buffer.bytes == storage + slot * slotByteCount,
+                     "buffer released to a pool it doesn't belong to")
+        let wasTaken = PlaneBufferRelease(flags + slot)
+        assert(wasTaken == 1, "plane buffer released twice")
+    }
+
+    var metrics: Metrics {
+        // acquire() counts an acquisition before its outcome, so reading acquisitions last
+        // keeps it at least hits plus misses while other threads are acquiring
+        let hits = PlaneBufferLoad(counters + 1)
+        let fallbacks = PlaneBufferLoad(counters + 2)
+        return Metrics(acquisitions: PlaneBufferLoad(counters), hits: hits,
+                       allocations: Int64(slotCount) + fallbacks)
+    }
+}
@@ -0,0 +1,123 @@
+//
+//  main.swift
+//  PlaneBufferPoolStress
+//
+//  Command line stress test for PlaneBufferPool, built from the app's own
+//  sources so it runs anywhere Swift does, Linux included:
+//
+//    swiftc -O -import-objc-header Basic-Video-Chat/PlaneBufferAtomics.h \
+//        Basic-Video-Chat/PlaneBufferPool.swift Basic-Video-Chat/PixelFormatConversion.swift \
+//        Basic-Video-Chat/PlaneBufferPoolStress/main.swift -o plane-buffer-pool-stress
+//    ./plane-buffer-pool-stress [threads] [iterations per thread]
+//
+//  Every thread acquires, holds and releases buffers in a loop. A pooled
+//  buffer carries an in-use flag in its first bytes that is claimed with a
+//  compare-and-swap on acquire and cleared on release, so a slot handed to
+//  two holders at once fails the claim. Holders also stamp the buffer with
+//  their own ID and check it is still there before releasing. At the end
+//  the pool's metrics have to match what the threads counted. Exits with a
+//  non-zero status on the first violation.
+//
+
+import Foundation
+
+private func check(_ condition: @autoclosure () -> Bool, _ message: @autoclosure () -> String) {
+    guard condition() else {
+        FileHandle.standardError.write("FAILED: \(message())\n".data(using: .utf8)!)
+        exit(1)
+    }
+}
+
+private let arguments = CommandLine.arguments
+private let threadCount = arguments.count > 1 ? Int(arguments[1]) ?? 8 : 8
+private let iterations = arguments.count > 2 ? Int(arguments[2]) ?? 200_000 : 200_000
+
+private let layout = PlaneBufferLayout(width: 64, height: 48, pixelFormat: .i420)
+
+// Byte offsets inside a buffer: the in-use flag, then the holder's stamp
+private let flagOffset = 0
+private let stampOffset = 64
+
+// MARK: - Single-threaded accounting
+
+do {
+    let smallPool = PlaneBufferPool(layout: layout, slotCount: 3)
+    let held = (0 ..< 4).map { _ in smallPool.acquire() }
+    check(held.prefix(3).allSatisfy { $0.isPooled }, "the first acquisitions must come from slots")
+    check(!held[3].isPooled, "an acquisition past the slot count must fall back to the heap")
+    check(Set(held.map { $0.bytes }).count == held.count, "buffers held at the same time must not overlap")
+    held.forEach(smallPool.release)
+
+    check(smallPool.acquire().isPooled, "a released slot must be reusable")
+    let counted = smallPool.metrics
+    check(counted.acquisitions == 5 && counted.hits == 4 && counted.misses == 1,
+          "counted \(counted.acquisitions) acquisitions, \(counted.hits) hits, expected 5 and 4")
+    check(counted.allocations == 4, "counted \(counted.allocations) allocations, expected 3 slots plus 1 miss")
+}
+
+// MARK: - Concurrent hand-out
+
+// Fewer slots than threads, so slots are fought over and some acquisitions fall back
+let pool = PlaneBufferPool(layout: layout, slotCount: max(1, threadCount / 2))
+
+// Clear every slot's flag before the threads start
+do {
+    let slots = (0 ..< pool.slotCount).map { _ in pool.acquire() }
+    for buffer in slots {
+        (buffer.bytes + flagOffset).storeBytes(of: 0, as: Int32.self)
+    }
+    slots.forEach(pool.release)
+}
+let baseline = pool.metrics
+
+let hits = UnsafeMutablePointer<Int>.allocate(capacity: threadCount)
+hits.initialize(repeating: 0, count: threadCount)
+
+let start = Date()
+DispatchQueue.concurrentPerform(iterations: threadCount) { thread in
+    let stamp = UInt64(thread + 1)
+    var threadHits = 0
+    for iteration in 0 ..< iterations {
+        let buffer = pool.acquire()
+        let flag = (buffer.bytes + flagOffset).assumingMemoryBound(to: Int32.self)
+        if buffer.isPooled {
+            threadHits += 1
+            check(PlaneBufferTryClaim(flag), "thread \(thread) was handed a slot that is still held")
+        }
+        let stampPointer = (buffer.bytes + stampOffset).assumingMemoryBound(to: UInt64.self)
+        stampPointer.pointee = stamp
+
+        // Hold the buffer across a yield now and then, so holders overlap
+        if iteration % 8 == 0 {
+            sched_yield()
+        }
+
+        check(stampPointer.pointee == stamp, "thread \(thread) found another holder's stamp in its buffer")
+        if buffer.isPooled {
+            check(PlaneBufferRelease(flag) == 1, "thread \(thread) found its slot's flag cleared by someone else")
+        }
+        pool.release(buffer)
+    }
+    hits[thread] = threadHits
+}
+let elapsed = Date().timeIntervalSince(start)
+
+let metrics = pool.metrics
+let acquisitions = Int64(threadCount * iterations)
+let countedHits = Int64((0 ..< threadCount).reduce(0) { $0 + hits[$1] })
+hits.deallocate()
+check(metrics.acquisitions - baseline.acquisitions == acquisitions,
+      "pool counted \(metrics.acquisitions - baseline.acquisitions) acquisitions, threads made \(acquisitions)")
+check(metrics.hits - baseline.hits == countedHits,
+      "pool counted \(metrics.hits - baseline.hits) hits, threads got \(countedHits) pooled buffers")
+check(metrics.allocations == Int64(pool.slotCount) + metrics.misses,
+      "pool counted \(metrics.allocations) allocations for \(pool.slotCount) slots and \(metrics.misses) misses")
+
+// Every slot must be free again
+let drained = (0 ..< pool.slotCount).map { _ in pool.acquire() }
+check(drained.allSatisfy { $0.isPooled }, "a slot was not released")
+drained.forEach(pool.release)
+
+print(String(format: "%ld threads x %ld acquisitions on %ld slots in %.2f s, hit rate %.1f%%",
+             threadCount, iterations, pool.slotCount, elapsed, metrics.hitRate * 100))
+print("OK")
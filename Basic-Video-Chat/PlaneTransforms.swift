@@ -0,0 +1,399 @@
+//
+//  PlaneTransforms.swift
+//  Basic-Video-Chat
+//
+//  Bilinear scaling and 90/180/270 degree rotation for the plane layouts in
+//  PixelFormatConversion.swift. Scaling blends two source rows with SIMD
+//  vectors, then samples that row horizontally eight output bytes at a time
+//  through precomputed offset and weight tables; larger reductions first
+//  average 2x2 blocks down to within 2x of the target. Rotation of one-byte
+//  planes transposes 8x8 tiles in SIMD registers, wider pixels go through
+//  small scalar tiles, so both the reads and the writes stay within a few
+//  cache lines. Like the conversions, this only uses Foundation and never
+//  allocates per frame.
+//
+
+import Foundation
+
+/// Bilinear resampling of one plane with `channels` interleaved bytes per pixel
+/// (1 for Y, U or V, 2 for NV12's UV, 4 for ARGB). Meant for downscaling by up to 2x,
+/// beyond that it skips source pixels and aliases (I420Scaler halves first); tables and
+/// the row buffer are sized once, so reuse one scaler per resolution pair.
+final class BilinearScaler {
+    let sourceWidth: Int
+    let sourceHeight: Int
+    let destinationWidth: Int
+    let destinationHeight: Int
+    let channels: Int
+
+    // Per destination byte: offsets of the left and right source bytes in the row buffer and
+    // their weights, which add up to 256. Vectors of eight are loaded straight from these.
+    private let leftOffsets: UnsafeMutablePointer<Int32>
+    private let rightOffsets: UnsafeMutablePointer<Int32>
+    private let leftWeights: UnsafeMutablePointer<UInt16>
+    private let rightWeights: UnsafeMutablePointer<UInt16>
+    // One vertically blended source row
+    private let rowBuffer: UnsafeMutablePointer<UInt8>
+
+    init(sourceWidth: Int, sourceHeight: Int, destinationWidth: Int, destinationHeight: Int, channels: Int = 1) {
+        precondition(sourceWidth > 0 && sourceHeight > 0 && destinationWidth > 0 && destinationHeight > 0,
+                     "plane sizes must be positive")
+        self.sourceWidth = sourceWidth
+        self.sourceHeight = sourceHeight
+        self.destinationWidth = destinationWidth
+        self.destinationHeight = destinationHeight
+        self.channels = channels
+
+        let byteCount = destinationWidth * channels
+        leftOffsets = UnsafeMutablePointer<Int32>.allocate(capacity: byteCount)
+        rightOffsets = UnsafeMutablePointer<Int32>.allocate(capacity: byteCount)
+        leftWeights = UnsafeMutablePointer<UInt16>.allocate(capacity: byteCount)
+        rightWeights = UnsafeMutablePointer<UInt16>.allocate(capacity: byteCount)
+        for column in 0 ..< destinationWidth {
+            let (index, weight) = BilinearScaler.sample(column, source: sourceWidth, destination: destinationWidth)
+            for channel in 0 ..< channels {
+                let i = column * channels + channel
+                leftOffsets[i] = Int32(index * channels + channel)
+                rightOffsets[i] = Int32(min(index + 1, sourceWidth - 1) * channels + channel)
+                leftWeights[i] = UInt16(256 - weight)
+                rightWeights[i] = UInt16(weight)
+            }
+        }
+        rowBuffer = UnsafeMutablePointer<UInt8>.allocate(capacity: sourceWidth * channels)
+    }
+
+    deinit {
+        leftOffsets.deallocate()
+        rightOffsets.deallocate()
+        leftWeights.deallocate()
+        rightWeights.deallocate()
+        rowBuffer.deallocate()
+    }
+
+    func scale(_ source: UnsafePointer<UInt8>, stride sourceStride: Int,
+               into destination: UnsafeMutablePointer<UInt8>, stride destinationStride: Int) {
+        let rowBytes = sourceWidth * channels
+        for row in 0 ..< destinationHeight {
+            let (top, weight) = BilinearScaler.sample(row, source: sourceHeight, destination: destinationHeight)
+            blendRows(source + top * sourceStride,
+                      source + min(top + 1, sourceHeight - 1) * sourceStride,
+                      weight: weight, count: rowBytes)
+
+            sampleRow(into: destination + row * destinationStride, count: destinationWidth * channels)
+        }
+    }
+
+    /// Horizontal pass over `rowBuffer`. The eight source bytes on each side are gathered
+    /// lane by lane through the offset tables, then blended as one vector.
+    private func sampleRow(into out: UnsafeMutablePointer<UInt8>, count: Int) {
+        var i = 0
+        while i + 8 <= count {
+            var left = SIMD8<UInt16>(), right = SIMD8<UInt16>()
+            for lane in 0 ..< 8 {
+                left[lane] = UInt16(rowBuffer[Int(leftOffsets[i + lane])])
+                right[lane] = UInt16(rowBuffer[Int(rightOffsets[i + lane])])
+            }
+            let leftWeight: SIMD8<UInt16> = loadVector(UnsafeRawPointer(leftWeights + i))
+            let rightWeight: SIMD8<UInt16> = loadVector(UnsafeRawPointer(rightWeights + i))
+            // The weights add up to 256, so 255 * 256 + 128 is the largest sum
+            let blended = (left &* leftWeight &+ right &* rightWeight &+ 128) &>> 8
+            storeVector(SIMD8<UInt8>(truncatingIfNeeded: blended), to: out + i)
+            i += 8
+        }
+        while i < count {
+            let blended = Int(rowBuffer[Int(leftOffsets[i])]) * Int(leftWeights[i])
+                + Int(rowBuffer[Int(rightOffsets[i])]) * Int(rightWeights[i]) + 128
+            out[i] = UInt8(truncatingIfNeeded: blended >> 8)
+            i += 1
+        }
+    }
+
+    private func blendRows(_ top: UnsafePointer<UInt8>, _ bottom: UnsafePointer<UInt8>, weight: Int, count: Int) {
+        guard weight > 0 else {
+            rowBuffer.assign(from: top, count: count)
+            return
+        }
+
+        let topWeight = UInt16(256 - weight), bottomWeight = UInt16(weight)
+        var i = 0
+        while i + 16 <= count {
+            let a = SIMD16<UInt16>(truncatingIfNeeded: loadVector(top + i) as SIMD16<UInt8>)
+            let b = SIMD16<UInt16>(truncatingIfNeeded: loadVector(bottom + i) as SIMD16<UInt8>)
+            // 255 * 256 + 128 still fits in 16 bits
+            let blended = (a &* topWeight &+ b &* bottomWeight &+ 128) &>> 8
+            storeVector(SIMD16<UInt8>(truncatingIfNeeded: blended), to: rowBuffer + i)
+            i += 16
+        }
+        while i < count {
+            let blended = Int(top[i]) * Int(topWeight) + Int(bottom[i]) * Int(bottomWeight) + 128
+            rowBuffer[i] = UInt8(truncatingIfNeeded: blended >> 8)
+            i += 1
+        }
+    }
+
+    /// Source pixel left of (or above) the center of destination pixel `position`, and the 8-bit
+    /// weight of the next source pixel. Pixel centers are aligned, as in CoreGraphics and libyuv.
+    private static func sample(_ position: Int, source: Int, destination: Int) -> (index: Int, weight: Int) {
+        let center = max(0, (Double(position) + 0.5) * Double(source) / Double(destination) - 0.5)
+        let index = min(Int(center), source - 1)
+        return (index, min(256, Int(((center - Double(index)) * 256).rounded())))
+    }
+}
+
+/// Scales all three I420 planes between two fixed resolutions. Reductions past 2x first
+/// halve the frame with a 2x2 box filter until the bilinear pass is within 2x, so every
+/// source pixel still contributes; the intermediate frames are allocated once, here.
+final class I420Scaler {
+    private struct Halving {
+        let width: Int
+        let height: Int
+        let planes: I420Planes
+    }
+
+    private let sourceWidth: Int
+    private let sourceHeight: Int
+    // Successively halved copies of the source, largest first
+    private let halvings: [Halving]
+    private let luma: BilinearScaler
+    private let chroma: BilinearScaler
+
+    init(sourceWidth: Int, sourceHeight: Int, destinationWidth: Int, destinationHeight: Int) {
+        self.sourceWidth = sourceWidth
+        self.sourceHeight = sourceHeight
+
+        var halvings: [Halving] = []
+        var width = sourceWidth, height = sourceHeight
+        while width > destinationWidth * 2 && height > destinationHeight * 2 {
+            width = I420Scaler.halved(width)
+            height = I420Scaler.halved(height)
+            halvings.append(Halving(width: width, height: height,
+                                    planes: I420Scaler.allocatePlanes(width: width, height: height)))
+        }
+        self.halvings = halvings
+
+        luma = BilinearScaler(sourceWidth: width, sourceHeight: height,
+                              destinationWidth: destinationWidth, destinationHeight: destinationHeight)
+        chroma = BilinearScaler(sourceWidth: PixelFormatConversion.chromaSize(width),
+                                sourceHeight: PixelFormatConversion.chromaSize(height),
+                                destinationWidth: PixelFormatConversion.chromaSize(destinationWidth),
+                                destinationHeight: PixelFormatConversion.chromaSize(destinationHeight))
+    }
+
+    deinit {
+        // Each frame's planes share the luma plane's allocation
+        halvings.forEach { $0.planes.y.deallocate() }
+    }
+
+    func scale(_ source: I420Planes, into destination: I420Planes) {
+        var planes = source
+        var width = sourceWidth, height = sourceHeight
+        for halving in halvings {
+            I420Scaler.halve(planes, width: width, height: height, into: halving.planes)
+            planes = halving.planes
+            width = halving.width
+            height = halving.height
+        }
+
+        luma.scale(planes.y, stride: planes.yStride, into: destination.y, stride: destination.yStride)
+        chroma.scale(planes.u, stride: planes.uStride, into: destination.u, stride: destination.uStride)
+        chroma.scale(planes.v, stride: planes.vStride, into: destination.v, stride: destination.vStride)
+    }
+
+    // Rounds up, so halving a frame's chroma size gives the halved frame's chroma size
+    private static func halved(_ size: Int) -> Int {
+        return (size + 1) / 2
+    }
+
+    private static func halve(_ source: I420Planes, width: Int, height: Int, into destination: I420Planes) {
+        let chromaWidth = PixelFormatConversion.chromaSize(width)
+        let chromaHeight = PixelFormatConversion.chromaSize(height)
+        halvePlane(source.y, stride: source.yStride, width: width, height: height,
+                   into: destination.y, stride: destination.yStride)
+        halvePlane(source.u, stride: source.uStride, width: chromaWidth, height: chromaHeight,
+                   into: destination.u, stride: destination.uStride)
+        halvePlane(source.v, stride: source.vStride, width: chromaWidth, height: chromaHeight,
+                   into: destination.v, stride: destination.vStride)
+    }
+
+    /// Averages every 2x2 block of a one-byte-per-pixel plane. An odd last row or column is
+    /// averaged with itself.
+    private static func halvePlane(_ source: UnsafePointer<UInt8>, stride sourceStride: Int, width: Int, height: Int,
+                                   into destination: UnsafeMutablePointer<UInt8>, stride destinationStride: Int) {
+        let halfWidth = halved(width)
+        for row in 0 ..< halved(height) {
+            let top = source + 2 * row * sourceStride
+            let bottom = source + min(2 * row + 1, height - 1) * sourceStride
+            let out = destination + row * destinationStride
+
+            var column = 0
+            while 2 * column + 16 <= width {
+                let sum = SIMD16<UInt16>(truncatingIfNeeded: loadVector(top + 2 * column) as SIMD16<UInt8>)
+                    &+ SIMD16<UInt16>(truncatingIfNeeded: loadVector(bottom + 2 * column) as SIMD16<UInt8>)
+                // Neighbouring pixels sit in the even and odd lanes
+                let averaged = (sum.evenHalf &+ sum.oddHalf &+ 2) &>> 2
+                storeVector(SIMD8<UInt8>(truncatingIfNeeded: averaged), to: out + column)
+                column += 8
+            }
+            while column < halfWidth {
+                let left = 2 * column, right = min(2 * column + 1, width - 1)
+                let sum = Int(top[left]) + Int(top[right]) + Int(bottom[left]) + Int(bottom[right]) + 2
+                out[column] = UInt8(truncatingIfNeeded: sum >> 2)
+                column += 1
+            }
+        }
+    }
+
+    /// Tightly packed planes in one allocation, freed through the luma pointer.
+    private static func allocatePlanes(width: Int, height: Int) -> I420Planes {
+        let chromaWidth = PixelFormatConversion.chromaSize(width)
+        let chromaHeight = PixelFormatConversion.chromaSize(height)
+        let lumaCount = width * height, chromaCount = chromaWidth * chromaHeight
+        let y = UnsafeMutablePointer<UInt8>.allocate(capacity: lumaCount + 2 * chromaCount)
+        return I420Planes(y: y, yStride: width,
+                          u: y + lumaCount, uStride: chromaWidth,
+                          v: y + lumaCount + chromaCount, vStride: chromaWidth)
+    }
+}
+
+/// Clockwise rotation applied to a frame. Quarter turns swap the destination's width and height.
+enum PlaneRotation {
+    case none
+    case clockwise90
+    case clockwise180
+    case clockwise270
+
+    var swapsDimensions: Bool {
+        return self == .clockwise90 || self == .clockwise270
+    }
+
+    static func rotate(_ source: I420Planes, width: Int, height: Int,
+                       into destination: I420Planes, by rotation: PlaneRotation) {
+        let chromaWidth = PixelFormatConversion.chromaSize(width)
+        let chromaHeight = PixelFormatConversion.chromaSize(height)
+        rotatePlane(source.y, stride: source.yStride, width: width, height: height,
+                    into: destination.y, stride: destination.yStride, by: rotation, as: UInt8.self)
+        rotatePlane(source.u, stride: source.uStride, width: chromaWidth, height: chromaHeight,
+                    into: destination.u, stride: destination.uStride, by: rotation, as: UInt8.self)
+        rotatePlane(source.v, stride: source.vStride, width: chromaWidth, height: chromaHeight,
+                    into: destination.v, stride: destination.vStride, by: rotation, as: UInt8.self)
+    }
+
+    static func rotate(_ source: NV12Planes, width: Int, height: Int,
+                       into destination: NV12Planes, by rotation: PlaneRotation) {
+        rotatePlane(source.y, stride: source.yStride, width: width, height: height,
+                    into: destination.y, stride: destination.yStride, by: rotation, as: UInt8.self)
+        // U, V pairs move together
+        rotatePlane(source.uv, stride: source.uvStride,
+                    width: PixelFormatConversion.chromaSize(width), height: PixelFormatConversion.chromaSize(height),
+                    into: destination.uv, stride: destination.uvStride, by: rotation, as: UInt16.self)
+    }
+
+    static func rotate(_ source: ARGBPlane, width: Int, height: Int,
+                       into destination: ARGBPlane, by rotation: PlaneRotation) {
+        rotatePlane(source.pixels, stride: source.stride, width: width, height: height,
+                    into: destination.pixels, stride: destination.stride, by: rotation, as: UInt32.self)
+    }
+
+    /// Rotates a `width` x `height` plane of `Pixel`-sized elements. Strides are in bytes.
+    static func rotatePlane<Pixel: FixedWidthInteger>(
+        _ source: UnsafeMutablePointer<UInt8>, stride sourceStride: Int, width: Int, height: Int,
+        into destination: UnsafeMutablePointer<UInt8>, stride destinationStride: Int,
+        by rotation: PlaneRotation, as pixel: Pixel.Type) {
+        let rowBytes = width * MemoryLayout<Pixel>.size
+        let src = UnsafeMutableRawPointer(source)
+        let dst = UnsafeMutableRawPointer(destination)
+
+        switch rotation {
+        case .none:
+            PixelFormatConversion.copyPlane(source, stride: sourceStride, to: destination, stride: destinationStride,
+                                            rowBytes: rowBytes, rows: height)
+
+        case .clockwise180:
+            for row in 0 ..< height {
+                let input = (src + row * sourceStride).assumingMemoryBound(to: Pixel.self)
+                let output = (dst + (height - 1 - row) * destinationStride).assumingMemoryBound(to: Pixel.self)
+                for column in 0 ..< width {
+                    output[width - 1 - column] = input[column]
+                }
+            }
+
+        case .clockwise90, .clockwise270:
+            // Source (x, y) lands at row x, column height - 1 - y for 90 degrees,
+            // and at row width - 1 - x, column y for 270 degrees
+            let isClockwise90 = rotation == .clockwise90
+
+            func rotateTiles(rows: Range<Int>, columns: Range<Int>) {
+                let tile = 16
+                for tileRow in Swift.stride(from: rows.lowerBound, to: rows.upperBound, by: tile) {
+                    for tileColumn in Swift.stride(from: columns.lowerBound, to: columns.upperBound, by: tile) {
+                        for row in tileRow ..< min(tileRow + tile, rows.upperBound) {
+                            let input = (src + row * sourceStride).assumingMemoryBound(to: Pixel.self)
+                            let outputColumn = isClockwise90 ? height - 1 - row : row
+                            for column in tileColumn ..< min(tileColumn + tile, columns.upperBound) {
+                                let outputRow = isClockwise90 ? column : width - 1 - column
+                                (dst + outputRow * destinationStride)
+                                    .assumingMemoryBound(to: Pixel.self)[outputColumn] = input[column]
+                            }
+                        }
+                    }
+                }
+            }
+
+            var vectorRows = 0, vectorColumns = 0
+            if Pixel.self == UInt8.self {
+                vectorRows = height / 8 * 8
+                vectorColumns = width / 8 * 8
+                transposeBytes(source, stride: sourceStride, rows: vectorRows, columns: vectorColumns,
+                               planeWidth: width, planeHeight: height,
+                               into: destination, stride: destinationStride, clockwise90: isClockwise90)
+            }
+            // The right and bottom edges the 8x8 tiles don't cover
+            rotateTiles(rows: 0 ..< height, columns: vectorColumns ..< width)
+            rotateTiles(rows: vectorRows ..< height, columns: 0 ..< vectorColumns)
+        }
+    }
+
+    /// Quarter turn of the top-left `rows` x `columns` of a one-byte plane, both multiples of 8,
+    /// one 8x8 tile at a time. For 90 degrees the tile's rows are loaded bottom up, so after the
+    /// transpose every tile row is a destination row in left-to-right order.
+    private static func transposeBytes(_ source: UnsafeMutablePointer<UInt8>, stride sourceStride: Int,
+                                       rows: Int, columns: Int, planeWidth: Int, planeHeight: Int,
+                                       into destination: UnsafeMutablePointer<UInt8>, stride destinationStride: Int,
+                                       clockwise90: Bool) {
+        var tile = SIMD64<UInt8>()
+        for tileRow in Swift.stride(from: 0, to: rows, by: 8) {
+            for tileColumn in Swift.stride(from: 0, to: columns, by: 8) {
+                withUnsafeMutableBytes(of: &tile) { bytes in
+                    for row in 0 ..< 8 {
+                        let sourceRow = clockwise90 ? tileRow + 7 - row : tileRow + row
+                        (bytes.baseAddress! + row * 8).copyMemory(from: source + sourceRow * sourceStride + tileColumn,
+                                                                   byteCount: 8)
+                    }
+                }
+
+                let transposed = transpose8x8(tile)
+
+                let outputColumn = clockwise90 ? planeHeight - 8 - tileRow : tileRow
+                withUnsafeBytes(of: transposed) { bytes in
+                    for row in 0 ..< 8 {
+                        let outputRow = clockwise90 ? tileColumn + row : planeWidth - 1 - tileColumn - row
+                        (destination + outputRow * destinationStride + outputColumn)
+                            .assign(from: bytes.baseAddress!.assumingMemoryBound(to: UInt8.self) + row * 8, count: 8)
+                    }
+                }
+            }
+        }
+    }
+
+    /// Transposes an 8x8 byte matrix stored row by row. Gathering the even lanes, then the odd
+    /// ones, rotates the six bits of a lane index (three of row, three of column) right by one,
+    /// so three rounds swap row and column.
+    @inline(__always)
+    private static func transpose8x8(_ tile: SIMD64<UInt8>) -> SIMD64<UInt8> {
+        var result = tile
+        for _ in 0 ..< 3 {
+            result = SIMD64(lowHalf: result.evenHalf, highHalf: result.oddHalf)
+        }
+        return result
+    }
+}
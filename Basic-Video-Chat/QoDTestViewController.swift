@@ -55,6 +55,9 @@ class QoDTestViewController: UIViewController {
         return label
     }()
     
+    // Live view of the samples being collected, between the stats and the buttons
+    private let liveStatsChart = LiveStatsChart()
+    
     // Stats tracking variables
     private var lastSubscriberBytesReceived: UInt64 = 0
     private var lastSubscriberStatsTimestamp: TimeInterval = 0
@@ -68,23 +71,52 @@ class QoDTestViewController: UIViewController {
     private let msisdn: String
     private let isHighQuality: Bool
     
+    // Publishes a synthetic test pattern instead of the camera when set
+    private let syntheticVideo: SyntheticPattern.Configuration?
+    
+    // Virtualized grid for large sessions, replaces the scroll view of OTSubscriber views when set
+    private let subscriberGrid: SubscriberGridView?
+    
+    // Automated A/B mode, nil when QoD is toggled manually
+    private let abTestConfiguration: ABTestConfiguration?
+    private var abTestRunner: ABTestRunner?
+    
     // Initialize with MSISDN and video quality
-    init(msisdn: String, isHighQuality: Bool) {
+    init(msisdn: String, isHighQuality: Bool, syntheticVideo: SyntheticPattern.Configuration? = nil,
+         usesSubscriberGrid: Bool = false, abTestConfiguration: ABTestConfiguration? = nil) {
         self.msisdn = msisdn
         self.isHighQuality = isHighQuality
+        self.syntheticVideo = syntheticVideo
+        self.subscriberGrid = usesSubscriberGrid ? SubscriberGridView() : nil
+        self.abTestConfiguration = abTestConfiguration
         super.init(nibName: nil, bundle: nil)
     }
     
     required init?(coder: NSCoder) {
         self.msisdn = ""  // Default value when initialized from storyboard
         self.isHighQuality = false  // Default value when initialized from storyboard
+        self.syntheticVideo = nil
+        self.subscriberGrid = nil
+        self.abTestConfiguration = nil
         super.init(coder: coder)
     }
     
     // OpenTok objects
     var session: OTSession?
     var publisher: OTPublisher?
-    var subscribers: [String: OTSubscriber] = [:] // Changed to dictionary of subscribers
+    var subscribers: [String: OTSubscriberKit] = [:] // OTSubscriber with its own view, or view-less in the grid
+    // Frame-level quality probes in front of each subscriber's renderer, by stream ID
+    private var qualityProbes: [String: QualityProbeRender] = [:]
+    // Publishers' clock offsets for latency, and the stamper for camera frames
+    private var clockSync: SessionClockSync?
+    private let captureStamper = CaptureStampTransformer()
+    // Preferred resolution and frame rate per subscriber, from tile size, visibility and downlink
+    private let qualityPolicy = SubscriberQualityPolicy()
+    // Pauses video of tiles scrolled out of view, resumes it one tile ahead
+    private let visibilityTracker = SubscriberVisibilityTracker(gracePeriod: 3)
+    // Tiles in join order; layout passes only touch tiles that are new or move
+    private let tileLayout = SubscriberTileLayout()
+    private var isSubscriberLayoutPending = false
     
     // Add a UIButton property
     var qodButton: UIButton!
@@ -106,6 +138,11 @@ class QoDTestViewController: UIViewController {
     // QoD Properties
     var sessionStatusTimer: Timer?
     var sessions: [String: Session] = [:]
+    var currentQodSessionId: String?
+    // Identifies the POST /qod still waiting for an answer; a session created by any
+    // other request belongs to a window that is already over and is deleted on arrival
+    private var qodRequestCount = 0
+    private var pendingQodRequest: Int?
     
     // QoD Status UI
     private lazy var qodStatusLabel: UILabel = {
@@ -122,6 +159,26 @@ class QoDTestViewController: UIViewController {
         return label
     }()
     
+    // Subscribers receiving video and the inbound video bitrate, so pausing off-screen tiles shows
+    private lazy var subscriberVideoLabel: UILabel = {
+        let label = UILabel()
+        label.textColor = .black
+        label.font = .systemFont(ofSize: 14)
+        label.adjustsFontSizeToFitWidth = true
+        label.minimumScaleFactor = 0.8
+        return label
+    }()
+    
+    // Current window of an automated A/B run, empty otherwise
+    private lazy var abTestStatusLabel: UILabel = {
+        let label = UILabel()
+        label.textColor = .black
+        label.font = .systemFont(ofSize: 14)
+        label.adjustsFontSizeToFitWidth = true
+        label.minimumScaleFactor = 0.8
+        return label
+    }()
+    
     override func viewDidLoad() {
         super.viewDidLoad()
         
@@ -129,6 +186,7 @@ class QoDTestViewController: UIViewController {
         setupButtons()
         setupTitleLabel()
         setupSectionHeaders()
+        setupLiveStatsChart()
     }
     
     // MARK: - RTC Stats Collection
@@ -152,20 +210,121 @@ class QoDTestViewController: UIViewController {
                     print("Skipping stats collection - publisher or subscriber not ready")
                     return
                 }
-                print("Requesting RTC stats report...")
+                SampleLog.print("Requesting RTC stats report...")
                 publisher.getRtcStatsReport()
                 
                 // Also collect stats from subscribers
                 for subscriber in self.subscribers.values {
                     subscriber.getRtcStatsReport()
                 }
+                self.recordFrameQuality()
+                self.updateSubscriberVisibility()
+                self.updateSubscriberQuality()
+                self.recordSubscriberVideo()
+            }
+            self?.startABTestIfNeeded()
+        }
+    }
+    
+    /// Closes every probe's window; runs on the stats timer, next to the RTC stats requests.
+    private func recordFrameQuality() {
+        let timestamp = Date().timeIntervalSince1970 * 1000
+        let now = ProcessInfo.processInfo.systemUptime
+        for subscriber in subscribers.values {
+            if let connection = subscriber.stream?.connection {
+                clockSync?.pingIfDue(connection)
+            }
+        }
+        var streams: [FrameQualityStats] = []
+        for (streamId, probe) in qualityProbes {
+            let stats = probe.analyzer.takeWindow(timestamp: timestamp, now: now, qodEnabled: isQoDEnabled)
+            // A paused stream has no frames to judge
+            guard !visibilityTracker.isPaused(streamId) else { continue }
+            streams.append(stats)
+            SampleLog.print("Frame quality \(stats.streamId): \(String(format: "%.1f", stats.frameRate)) fps, " +
+                            "jitter \(String(format: "%.1f", stats.intervalJitterMs)) ms, " +
+                            "\(stats.freezeCount) freezes, " +
+                            "blockiness \(String(format: "%.2f", stats.blockiness)), " +
+                            "sharpness \(String(format: "%.1f", stats.sharpness))" +
+                            (stats.psnr.map { ", PSNR \(String(format: "%.1f", $0)) dB" } ?? "") +
+                            (stats.ssim.map { ", SSIM \(String(format: "%.3f", $0))" } ?? "") +
+                            (stats.latencyMs.map { ", latency \(String(format: "%.0f", $0)) ms" } ?? ""))
+        }
+        if !streams.isEmpty {
+            videoResult?.append(FrameQualityTick(timestamp: timestamp, qodEnabled: isQoDEnabled, streams: streams))
+        }
+    }
+    
+    /// Tile frames and the visible part of whichever container shows the subscribers, in the same coordinates.
+    private func subscriberTiles() -> (frames: [String: CGRect], visibleBounds: CGRect) {
+        if let grid = subscriberGrid {
+            return (grid.tileFrames, grid.visibleBounds)
+        }
+        var frames: [String: CGRect] = [:]
+        for (streamId, subscriber) in subscribers {
+            if let subsView = (subscriber as? OTSubscriber)?.view, subsView.superview === subscribersScrollView {
+                frames[streamId] = subsView.frame
             }
         }
+        return (frames, subscribersScrollView.bounds)
+    }
+    
+    /// Pauses or resumes subscriber video by tile visibility; runs on scroll and on the stats timer.
+    private func updateSubscriberVisibility() {
+        let tiles = subscriberTiles()
+        let changes = visibilityTracker.update(tiles: tiles.frames, visibleBounds: tiles.visibleBounds,
+                                               now: ProcessInfo.processInfo.systemUptime)
+        for (streamId, receivesVideo) in changes {
+            guard let subscriber = subscribers[streamId] else { continue }
+            subscriber.subscribeToVideo = receivesVideo
+            qualityProbes[streamId]?.analyzer.resetTiming()
+            SampleLog.print("Subscriber \(streamId) video \(receivesVideo ? "resumed" : "paused"): " +
+                            "\(subscribers.count - visibilityTracker.pausedStreamIds.count) of \(subscribers.count) " +
+                            "receiving video, \(String(format: "%.0f", qualityPolicy.receivedKbps)) Kbps inbound")
+        }
+    }
+    
+    /// Records how many subscribers receive video and the video bitrate they bring in; runs on the stats timer.
+    private func recordSubscriberVideo() {
+        let sample = SubscriberVideoSample(timestamp: Date().timeIntervalSince1970 * 1000,
+                                           receivingCount: subscribers.keys.filter { !visibilityTracker.isPaused($0) }.count,
+                                           subscriberCount: subscribers.count,
+                                           inboundKbps: qualityPolicy.receivedKbps,
+                                           qodEnabled: isQoDEnabled)
+        videoResult?.append(sample)
+        subscriberVideoLabel.text = "Receiving video: \(sample.receivingCount) of \(sample.subscriberCount), " +
+            "\(String(format: "%.0f", sample.inboundKbps)) Kbps in"
+    }
+    
+    /// Applies the policy's level changes; runs on the stats timer, after the reports were requested.
+    private func updateSubscriberQuality() {
+        let tiles = subscriberTiles()
+        let scale = UIScreen.main.scale
+        var viewports: [String: SubscriberViewport] = [:]
+        for (streamId, frame) in tiles.frames {
+            // Paused streams receive no video, so they take none of the downlink
+            guard !frame.isEmpty, !visibilityTracker.isPaused(streamId) else { continue }
+            let visible = frame.intersection(tiles.visibleBounds)
+            let visibleArea = visible.isNull ? 0 : visible.width * visible.height
+            viewports[streamId] = SubscriberViewport(
+                tileSize: CGSize(width: frame.width * scale, height: frame.height * scale),
+                visibleFraction: Double(visibleArea / (frame.width * frame.height)))
+        }
+        
+        for (streamId, level) in qualityPolicy.update(viewports) {
+            guard let subscriber = subscribers[streamId] else { continue }
+            subscriber.preferredResolution = level.resolution
+            subscriber.preferredFrameRate = level.frameRate
+            SampleLog.print("Subscriber \(streamId) preferring \(Int(level.resolution.width))x\(Int(level.resolution.height)) " +
+                            "at \(level.frameRate) fps" +
+                            (qualityPolicy.downlink.capacityKbps.map { ", downlink \(String(format: "%.0f", $0)) Kbps" } ?? ""))
+        }
     }
     
     private func stopRTCStatsCollection() {
         statsTimer?.invalidate()
         statsTimer = nil
+        liveStatsChart.stop()
     }
     
     private func updateNetworkQualityPosition() {
@@ -227,11 +386,18 @@ class QoDTestViewController: UIViewController {
                                            height: streamHeight)
         
         // Add views in order
-        view.addSubview(subscribersScrollView)
+        if let grid = subscriberGrid {
+            grid.frame = subscribersScrollView.frame
+            grid.onVisibleTilesChange = { [weak self] in self?.updateSubscriberVisibility() }
+            view.addSubview(grid)
+        } else {
+            subscribersScrollView.delegate = self
+            view.addSubview(subscribersScrollView)
+        }
         view.addSubview(statsView)
         
         // Position the stats container view
-        let containerHeight: CGFloat = 160 // Increased to accommodate header
+        let containerHeight: CGFloat = 220 // Increased to accommodate header, subscriber video and the A/B status
         let statsY = subscribersScrollView.frame.origin.y + streamHeight + 60 // Position after scroll view height plus spacing
         statsView.frame = CGRect(x: 20,
                                 y: statsY,
@@ -251,6 +417,8 @@ class QoDTestViewController: UIViewController {
         statsView.addSubview(qodStatusValueLabel)
         statsView.addSubview(bitrateLabel)
         statsView.addSubview(packetLossLabel)
+        statsView.addSubview(subscriberVideoLabel)
+        statsView.addSubview(abTestStatusLabel)
         
         let labelPadding: CGFloat = 15
         
@@ -276,6 +444,16 @@ class QoDTestViewController: UIViewController {
                                        width: statsView.frame.width - (2 * labelPadding),
                                        height: 20)
         
+        subscriberVideoLabel.frame = CGRect(x: labelPadding,
+                                            y: packetLossLabel.frame.maxY + 10,
+                                            width: statsView.frame.width - (2 * labelPadding),
+                                            height: 20)
+        
+        abTestStatusLabel.frame = CGRect(x: labelPadding,
+                                         y: subscriberVideoLabel.frame.maxY + 10,
+                                         width: statsView.frame.width - (2 * labelPadding),
+                                         height: 20)
+        
         // Fetch session details from the backend before connecting
         fetchSessionDetails()
     }
@@ -320,13 +498,34 @@ class QoDTestViewController: UIViewController {
         )
     }
     
+    private func setupLiveStatsChart() {
+        view.addSubview(liveStatsChart.chartView)
+        
+        // Fill the space between the stats container and the buttons
+        let y = statsView.frame.maxY + 10
+        liveStatsChart.chartView.frame = CGRect(x: 20,
+                                                y: y,
+                                                width: view.frame.width - 40,
+                                                height: max(0, endTestButton.frame.minY - 10 - y))
+    }
+    
     @objc private func handleEndTest() {
         // Stop collecting stats
         stopRTCStatsCollection()
         
+        // Close out an unfinished A/B run so its windows still line up with the samples
+        if let runner = abTestRunner {
+            runner.cancel()
+            if let sessionId = currentQodSessionId {
+                deleteQodSession(sessionId)
+            }
+        }
+        
         // Push results view controller if we have stats
         if let result = videoResult {
-            let resultsVC = TestResultsViewController(videoResult: result)
+            result.windows = abTestRunner?.windows ?? []
+            let resultsVC = TestResultsViewController(videoResult: result,
+                                                      settleTime: abTestConfiguration?.settleTime ?? 0)
             navigationController?.pushViewController(resultsVC, animated: true)
         } else {
             print("No stats collected")
@@ -552,15 +751,21 @@ class QoDTestViewController: UIViewController {
         request.httpBody = httpBody
         request.setValue("application/json", forHTTPHeaderField: "Content-Type")
         
+        qodRequestCount += 1
+        let requestId = qodRequestCount
+        pendingQodRequest = requestId
+        
         // Perform the network request
         let task = URLSession.shared.dataTask(with: request) { [weak self] data, response, error in
             if let error = error {
                 print("Error making POST request: \(error)")
+                self?.finishQodRequest(requestId)
                 return
             }
             
             guard let data = data else {
                 print("No data returned from POST request")
+                self?.finishQodRequest(requestId)
                 return
             }
             
@@ -571,13 +776,26 @@ class QoDTestViewController: UIViewController {
                    let sessionId = json["id"] as? String {
                     print("Session ID: \(sessionId)")
                     
-                    // Fetch the session data using the session ID
-                    self?.fetchSessionById(sessionId)
+                    DispatchQueue.main.async {
+                        guard let self = self else { return }
+                        // The A/B window this request was made for may already be over
+                        guard self.pendingQodRequest == requestId else {
+                            self.deleteQodSession(sessionId)
+                            return
+                        }
+                        self.pendingQodRequest = nil
+                        self.currentQodSessionId = sessionId
+                        
+                        // Fetch the session data using the session ID
+                        self.fetchSessionById(sessionId)
+                    }
                 } else {
                     print("Failed to parse JSON or 'id' not found")
+                    self?.finishQodRequest(requestId)
                 }
             } catch let jsonError {
                 print("Failed to parse JSON response: \(jsonError)")
+                self?.finishQodRequest(requestId)
                 
                 // For debugging, print the response as a string
                 if let responseString = String(data: data, encoding: .utf8) {
@@ -590,6 +808,45 @@ class QoDTestViewController: UIViewController {
         task.resume()
     }
     
+    // Called from URLSession's queue when POST /qod ended without a session
+    private func finishQodRequest(_ requestId: Int) {
+        DispatchQueue.main.async { [weak self] in
+            guard self?.pendingQodRequest == requestId else { return }
+            self?.pendingQodRequest = nil
+        }
+    }
+    
+    // Tears down a QoD session so the following window runs on the default network profile
+    func deleteQodSession(_ sessionId: String) {
+        let urlString = "https://neru-b6ae7ba7-vonage-video-backend-server-dev.euw1.runtime.vonage.cloud/qod-sessions/\(sessionId)"
+        guard let url = URL(string: urlString) else { return }
+        
+        var request = URLRequest(url: url)
+        request.httpMethod = "DELETE"
+        
+        // Stop polling and treat QoD as off from here on; a late session of an earlier
+        // window was never current and leaves the current state alone
+        if currentQodSessionId == sessionId {
+            sessionStatusTimer?.invalidate()
+            sessionStatusTimer = nil
+            currentQodSessionId = nil
+            isQoDEnabled = false
+            qodStatusValueLabel.text = "DELETED"
+        }
+        sessions.removeValue(forKey: sessionId)
+        
+        let task = URLSession.shared.dataTask(with: request) { data, response, error in
+            if let error = error {
+                print("Error deleting QoD session: \(error)")
+                return
+            }
+            if let httpResponse = response as? HTTPURLResponse {
+                print("QoD session \(sessionId) deleted, status: \(httpResponse.statusCode)")
+            }
+        }
+        task.resume()
+    }
+    
     func startSessionStatusPolling(sessionId: String) {
         // Invalidate existing timer if any
         sessionStatusTimer?.invalidate()
@@ -633,6 +890,8 @@ class QoDTestViewController: UIViewController {
                 
                 // Update the sessions dictionary
                 DispatchQueue.main.async {
+                    // Ignore responses that arrive after the session was torn down
+                    guard self?.currentQodSessionId == sessionId else { return }
                     self?.sessions[sessionId] = session
                     self?.handleQoDStatus(with: session)
                     
@@ -671,15 +930,24 @@ class QoDTestViewController: UIViewController {
     
     func cleanupSubscriber() {
         subscribers.values.forEach { subscriber in
-            subscriber.view?.removeFromSuperview()
+            (subscriber as? OTSubscriber)?.view?.removeFromSuperview()
         }
         subscribers.removeAll()
+        tileLayout.removeAll()
+        subscriberGrid?.setStreamIds([])
+        qualityProbes.removeAll()
+        qualityPolicy.removeAll()
+        visibilityTracker.removeAll()
         updateSubscribersHeaderLabel()
     }
     
     fileprivate func doSubscribe(_ stream: OTStream) {
         var error: OTError?
-        guard let subscriber = OTSubscriber(stream: stream, delegate: self) else {
+        // Grid tiles draw through recycled render views, so grid subscribers don't get a view of their own
+        let newSubscriber: OTSubscriberKit? = subscriberGrid == nil
+            ? OTSubscriber(stream: stream, delegate: self)
+            : OTSubscriberKit(stream: stream, delegate: self)
+        guard let subscriber = newSubscriber else {
             print("Failed to create subscriber")
             return
         }
@@ -689,15 +957,44 @@ class QoDTestViewController: UIViewController {
         }
         
         subscriber.rtcStatsReportDelegate = self
+        
+        // The subscriber's own renderer draws its view, or the grid routes frames to a cell; keep either behind the probe
+        let probe = QualityProbeRender(streamId: stream.streamId,
+                                       forwardingTo: subscriberGrid?.router(for: stream.streamId) ?? subscriber.videoRender)
+        let connectionId = stream.connection.connectionId
+        // Called on the renderer's thread, so capture the sync object rather than reading self
+        probe.clockOffset = { [weak clockSync = self.clockSync] in clockSync?.offset(forConnectionId: connectionId) }
+        subscriber.videoRender = probe
+        
+        // Grid subscribers start audio-only; video comes on once their tile is in range
+        if subscriberGrid != nil {
+            subscriber.subscribeToVideo = false
+            visibilityTracker.markPaused(stream.streamId)
+        }
+        
         session?.subscribe(subscriber, error: &error)
         if error == nil {
             subscribers[stream.streamId] = subscriber
-            layoutSubscribers()
+            tileLayout.insert(stream.streamId)
+            qualityProbes[stream.streamId] = probe
+            setNeedsSubscriberLayout()
             updateSubscribersHeaderLabel()
         }
     }
     
+    /// Coalesces the layout passes of a burst of joins and leaves into one on the next run loop turn.
+    private func setNeedsSubscriberLayout() {
+        guard !isSubscriberLayoutPending else { return }
+        isSubscriberLayoutPending = true
+        DispatchQueue.main.async { [weak self] in
+            guard let self = self, self.isSubscriberLayoutPending else { return }
+            self.layoutSubscribers()
+        }
+    }
+    
     private func layoutSubscribers() {
+        isSubscriberLayoutPending = false
+        
         // Get layout parameters
         let safeAreaTopPadding = view.safeAreaInsets.top
         let titleHeight: CGFloat = 70 // Title section height including padding
@@ -718,6 +1015,16 @@ class QoDTestViewController: UIViewController {
         let aspectRatio = kWidgetWidth / kWidgetHeight
         let streamHeight = streamWidth / aspectRatio
         
+        if let grid = subscriberGrid {
+            grid.frame = CGRect(x: leftMargin, y: scrollViewY, width: availableWidth, height: streamHeight)
+            grid.setStreamIds(tileLayout.streamIds)
+            grid.layoutIfNeeded()
+            // Restart video one column before it scrolls in
+            visibilityTracker.prefetchMargin = grid.tileSize.width + grid.tileSpacing
+            updateSubscriberVisibility()
+            return
+        }
+        
         // Setup scroll view if not already added
         if subscribersScrollView.superview == nil {
             view.addSubview(subscribersScrollView)
@@ -729,33 +1036,23 @@ class QoDTestViewController: UIViewController {
                                            width: availableWidth,
                                            height: streamHeight)
         
-        // Layout subscribers horizontally
-        let subscriberArray = Array(subscribers.values)
-        var contentWidth: CGFloat = 0
-        
-        // Remove any existing subscriber views from scroll view
-        subscribersScrollView.subviews.forEach { $0.removeFromSuperview() }
-        
-        for (index, subscriber) in subscriberArray.enumerated() {
-            if let subsView = subscriber.view {
-                let x = CGFloat(index) * (streamWidth + streamSpacing)
-                
-                subsView.frame = CGRect(x: x,
-                                      y: 0,
-                                      width: streamWidth,
-                                      height: streamHeight)
-                
+        // Layout subscribers horizontally in join order, only touching tiles that are new or move
+        tileLayout.tileSize = CGSize(width: streamWidth, height: streamHeight)
+        tileLayout.spacing = streamSpacing
+        for (streamId, frame) in tileLayout.pendingFrames() {
+            guard let subsView = (subscribers[streamId] as? OTSubscriber)?.view else { continue }
+            subsView.frame = frame
+            if subsView.superview !== subscribersScrollView {
                 subscribersScrollView.addSubview(subsView)
-                
-                // Update content width
-                contentWidth = x + streamWidth
             }
         }
         
         // Set scroll view content size
-        subscribersScrollView.contentSize = CGSize(width: contentWidth + streamSpacing,
-                                                 height: streamHeight)
+        subscribersScrollView.contentSize = tileLayout.contentSize
         
+        // Restart video one tile before it scrolls in
+        visibilityTracker.prefetchMargin = streamWidth + streamSpacing
+        updateSubscriberVisibility()
     }
     
     fileprivate func doPublish() {
@@ -786,6 +1083,17 @@ class QoDTestViewController: UIViewController {
         publisher = pub
         pub.rtcStatsReportDelegate = self
         
+        // Same resolution and frame rate as the camera settings above, but reproducible content
+        if let syntheticVideo = syntheticVideo {
+            print("Publishing synthetic video (motion \(syntheticVideo.motion), entropy \(syntheticVideo.entropy))")
+            pub.videoCapture = isHighQuality
+                ? SyntheticVideoCapture(width: 1920, height: 1080, frameRate: 30, configuration: syntheticVideo)
+                : SyntheticVideoCapture(width: 640, height: 480, frameRate: 30, configuration: syntheticVideo)
+        } else if let stamper = OTVideoTransformer(name: "captureStamp", transformer: captureStamper) {
+            // Synthetic frames carry their capture time already; camera frames get it here
+            pub.videoTransformers = [stamper]
+        }
+        
         session?.publish(pub, error: &error)
         
         guard error == nil else {
@@ -885,7 +1193,11 @@ class QoDTestViewController: UIViewController {
                     self.kToken = sessionResponse.token
                     
                     // After fetching the details, initialize the OpenTok session
-                    self.session = OTSession(apiKey: self.kApiKey, sessionId: self.kSessionId, delegate: self)
+                    // Hundreds of subscriptions share one peer connection in grid mode
+                    let settings = OTSessionSettings()
+                    settings.singlePeerConnection = self.subscriberGrid != nil
+                    self.session = OTSession(apiKey: self.kApiKey, sessionId: self.kSessionId, delegate: self,
+                                             settings: settings)
                     print("session: \(self.kSessionId)")
                     print("token: \(self.kToken)")
                     
@@ -906,6 +1218,7 @@ class QoDTestViewController: UIViewController {
 extension QoDTestViewController: OTSessionDelegate {
     func sessionDidConnect(_ session: OTSession) {
         print("Session connected")
+        clockSync = SessionClockSync(session: session)
         doPublish()
         updateShareLinkText()
     }
@@ -925,22 +1238,31 @@ extension QoDTestViewController: OTSessionDelegate {
     func session(_ session: OTSession, streamDestroyed stream: OTStream) {
         print("Session streamDestroyed: \(stream.streamId)")
         if let subscriber = subscribers[stream.streamId] {
-            subscriber.view?.removeFromSuperview()
+            (subscriber as? OTSubscriber)?.view?.removeFromSuperview()
             subscribers.removeValue(forKey: stream.streamId)
-            layoutSubscribers() // Relayout remaining subscribers
+            tileLayout.remove(stream.streamId)
+            qualityProbes.removeValue(forKey: stream.streamId)
+            qualityPolicy.remove(streamId: stream.streamId)
+            visibilityTracker.remove(streamId: stream.streamId)
+            clockSync?.remove(connectionId: stream.connection.connectionId)
+            setNeedsSubscriberLayout() // Close the gap by shifting the tiles after it
         }
     }
     
     func session(_ session: OTSession, didFailWithError error: OTError) {
         print("Session failed to connect: \(error.localizedDescription)")
     }
+    
+    func session(_ session: OTSession, receivedSignalType type: String?, from connection: OTConnection?, with string: String?) {
+        clockSync?.handleSignal(type: type, from: connection, string: string)
+    }
 }
 
 // MARK: - OTPublisher delegate callbacks
 // MARK: - RTC Stats Report Delegates
 extension QoDTestViewController: OTPublisherKitRtcStatsReportDelegate, OTSubscriberKitRtcStatsReportDelegate {
-    private func processRTCStats(_ jsonArrayOfReports: String, isPublisher: Bool) {
-        print("Processing RTC stats for \(isPublisher ? "Publisher" : "Subscriber")")
+    private func processRTCStats(_ jsonArrayOfReports: String, isPublisher: Bool, streamId: String? = nil) {
+        SampleLog.print("Processing RTC stats for \(isPublisher ? "Publisher" : "Subscriber")")
         guard let data = jsonArrayOfReports.data(using: .utf8),
               let jsonArray = try? JSONSerialization.jsonObject(with: data) as? [[String: Any]] else {
             print("Failed to parse RTC stats JSON")
@@ -957,6 +1279,11 @@ extension QoDTestViewController: OTPublisherKitRtcStatsReportDelegate, OTSubscri
                 case "candidate-pair":
                     if let isNominated = report["nominated"] as? Bool, isNominated {
                         currentRoundTripTimeMs = (report["currentRoundTripTime"] as? Double ?? 0.0) * 1000
+                        if !isPublisher, let availableBitrate = report["availableIncomingBitrate"] as? Double {
+                            DispatchQueue.main.async { [weak self] in
+                                self?.qualityPolicy.recordAvailableIncoming(kbps: availableBitrate / 1000)
+                            }
+                        }
                     }
                 case "inbound-rtp" where !isPublisher:
                     if let kind = report["kind"] as? String, kind == "video" {
@@ -1001,7 +1328,10 @@ extension QoDTestViewController: OTPublisherKitRtcStatsReportDelegate, OTSubscri
                         packetLossRatio: packetLossRatio,
                         qodEnabled: isQoDEnabled
                     )
-                    videoResult?.qualityStats.append(videoStats)
+                    videoResult?.append(videoStats)
+                    DispatchQueue.main.async { [weak self] in
+                        self?.liveStatsChart.append(videoStats)
+                    }
                 }
                 
                 // Update UI on main thread
@@ -1010,6 +1340,16 @@ extension QoDTestViewController: OTPublisherKitRtcStatsReportDelegate, OTSubscri
                     self?.packetLossLabel.text = "Subscriber Packet Loss: \(String(format: "%.1f", packetLossRatio * 100))%"
                 }
                 
+                // Per-stream counters for the subscriber quality policy
+                if let streamId = streamId {
+                    DispatchQueue.main.async { [weak self] in
+                        self?.qualityPolicy.recordInbound(streamId: streamId, timestampMs: timestamp,
+                                                          bytesReceived: bytesReceived,
+                                                          packetsReceived: UInt64(packetsReceived),
+                                                          packetsLost: UInt64(packetsLost))
+                    }
+                }
+                
                 // Update values for next calculation
                 lastSubscriberBytesReceived = bytesReceived
                 lastSubscriberStatsTimestamp = timestamp
@@ -1022,7 +1362,7 @@ extension QoDTestViewController: OTPublisherKitRtcStatsReportDelegate, OTSubscri
     }
     
     func subscriber(_ subscriber: OTSubscriberKit, rtcStatsReport jsonArrayOfReports: String) {
-        processRTCStats(jsonArrayOfReports, isPublisher: false)
+        processRTCStats(jsonArrayOfReports, isPublisher: false, streamId: subscriber.stream?.streamId)
     }
 }
 
@@ -1052,7 +1392,7 @@ extension QoDTestViewController: OTSubscriberDelegate {
     func subscriberDidConnect(toStream subscriberKit: OTSubscriberKit) {
         print("Subscriber connected - starting RTC stats collection")
         startRTCStatsCollection()
-        layoutSubscribers()
+        setNeedsSubscriberLayout()
     }
     
     func subscriber(_ subscriber: OTSubscriberKit, didFailWithError error: OTError) {
@@ -1067,6 +1407,14 @@ struct SessionResponse: Codable {
     let token: String
 }
 
+extension QoDTestViewController: UIScrollViewDelegate {
+    func scrollViewDidScroll(_ scrollView: UIScrollView) {
+        // Also called for the share link text view, which is a scroll view too
+        guard scrollView === subscribersScrollView else { return }
+        updateSubscriberVisibility()
+    }
+}
+
 extension QoDTestViewController: UITextViewDelegate {
     func textView(_ textView: UITextView, shouldInteractWith URL: URL, in characterRange: NSRange, interaction: UITextItemInteraction) -> Bool {
         UIApplication.shared.open(URL)
@@ -1095,3 +1443,43 @@ extension QoDTestViewController {
         shareLinkTextView.delegate = self
     }
 }
+
+// MARK: - Automated A/B test
+extension QoDTestViewController: ABTestRunnerDelegate {
+    private func startABTestIfNeeded() {
+        guard let configuration = abTestConfiguration, abTestRunner == nil else { return }
+        
+        // The schedule owns the QoD toggle for the whole run
+        qodButton.isEnabled = false
+        qodButton.alpha = 0.5
+        
+        let runner = ABTestRunner(configuration: configuration)
+        runner.delegate = self
+        abTestRunner = runner
+        runner.start()
+    }
+    
+    func abTestRunner(_ runner: ABTestRunner, didBegin window: TestWindow) {
+        let windowCount = runner.configuration.repeatCount * 2
+        abTestStatusLabel.text = "A/B test: \(window.label) (window \(runner.windows.count) of \(windowCount))"
+        // Nothing from an earlier window may still tear down or claim this one's session
+        pendingQodRequest = nil
+        if window.kind == .qod {
+            sendQodRequest()
+        }
+    }
+    
+    func abTestRunner(_ runner: ABTestRunner, didEnd window: TestWindow) {
+        guard window.kind == .qod else { return }
+        if let sessionId = currentQodSessionId {
+            deleteQodSession(sessionId)
+        }
+        // A POST /qod that hasn't answered yet no longer belongs to a window, so the
+        // session it creates is deleted as soon as it arrives
+        pendingQodRequest = nil
+    }
+    
+    func abTestRunnerDidFinish(_ runner: ABTestRunner) {
+        handleEndTest()
+    }
+}
@@ -0,0 +1,61 @@
+//
+//  QualityProbeRender.swift
+//  Basic-Video-Chat
+//
+//  OTVideoRender installed in front of a subscriber's own renderer. Every
+//  frame is fed to a FrameQualityAnalyzer and then forwarded unchanged, so
+//  the subscriber view keeps drawing as before. Frames carrying a
+//  FrameStamp also yield:
+//
+//  - glass-to-glass latency, once `clockOffset` knows the publisher's clock,
+//  - PSNR/SSIM against the original when the stamp has a FrameReference,
+//    for every `referenceScoringInterval`-th one since rebuilding it costs a
+//    full frame.
+//
+
+import Foundation
+import OpenTok
+
+final class QualityProbeRender: NSObject, OTVideoRender {
+    let analyzer: FrameQualityAnalyzer
+    var referenceScoringInterval = 10
+    /// The publisher's clock minus ours in seconds, nil while unknown
+    var clockOffset: (() -> TimeInterval?)?
+    private let downstream: OTVideoRender?
+    private let scorer = ReferenceQualityScorer()
+    private var referencedFrameCount = 0
+
+    /// `downstream` is the subscriber's current `videoRender`, which draws its view.
+    init(streamId: String, forwardingTo downstream: OTVideoRender?) {
+        self.analyzer = FrameQualityAnalyzer(streamId: streamId)
+        self.downstream = downstream
+        super.init()
+    }
+
+    func renderVideoFrame(_ frame: OTVideoFrame) {
+        // I420 and NV12 both start with a full-size luma plane; ARGB frames only count for timing
+        var luma: LumaPlane?
+        if let planes = frame.i420Planes {
+            luma = LumaPlane(pixels: planes.y, stride: planes.yStride, width: frame.width, height: frame.height)
+        } else if let planes = frame.nv12Planes {
+            luma = LumaPlane(pixels: planes.y, stride: planes.yStride, width: frame.width, height: frame.height)
+        }
+        analyzer.addFrame(arrivalTime: ProcessInfo.processInfo.systemUptime, luma: luma)
+
+        if let metadata = frame.metadata, let stamp = FrameStamp(metadata: metadata) {
+            if let offset = clockOffset?() {
+                // Capture time moved onto our clock
+                let latency = Date().timeIntervalSince1970 - (stamp.captureTime - offset)
+                analyzer.addLatency(milliseconds: latency * 1000)
+            }
+            if let luma = luma, let reference = stamp.reference {
+                if referencedFrameCount % referenceScoringInterval == 0 {
+                    let score = scorer.score(received: luma, reference: reference)
+                    analyzer.addReferenceScore(psnr: score.psnr, ssim: score.ssim)
+                }
+                referencedFrameCount += 1
+            }
+        }
+        downstream?.renderVideoFrame(frame)
+    }
+}
@@ -0,0 +1,64 @@
+//
+//  main.swift
+//  ReducerBench
+//
+//  Cost of the point reducers a line chart can run before drawing: the
+//  Douglas-Peucker reducer from DGCharts against the LTTB and min/max
+//  reducers in DataApproximator+LTTB.swift. Needs the DGCharts module, so
+//  it builds on macOS only (see "Benchmarks" in the README):
+//
+//    swiftc -O -I .bench -L .bench -lDGCharts Basic-Video-Chat/BenchSupport/BenchSupport.swift \
+//        Basic-Video-Chat/DataApproximator+LTTB.swift Basic-Video-Chat/ReducerBench/main.swift -o reducer-bench
+//    DYLD_LIBRARY_PATH=.bench ./reducer-bench [points] [result count]
+//
+//  Besides the time per reduction it prints how far each result strays from
+//  the input: the largest vertical distance from an input point to the
+//  reduced line, and whether the global minimum and maximum survived.
+//
+
+import Foundation
+import CoreGraphics
+import DGCharts
+
+let pointCount = Bench.argument(1, default: 1_000_000)
+let resultCount = Bench.argument(2, default: 2000)
+
+var random = BenchRandom()
+let samples = random.series(count: pointCount)
+let points = zip(samples.x, samples.y).map { CGPoint(x: $0, y: $1) }
+print("\(pointCount) points reduced to \(resultCount)")
+
+/// Largest vertical distance from an input point to the polyline through `reduced`.
+func maxError(_ reduced: [CGPoint]) -> CGFloat {
+    var error: CGFloat = 0
+    var segment = 0
+    for point in points {
+        while segment < reduced.count - 2 && reduced[segment + 1].x < point.x {
+            segment += 1
+        }
+        let a = reduced[segment], b = reduced[min(segment + 1, reduced.count - 1)]
+        let t = b.x > a.x ? (point.x - a.x) / (b.x - a.x) : 0
+        error = max(error, abs(point.y - (a.y + (b.y - a.y) * t)))
+    }
+    return error
+}
+
+let yMin = samples.y.min() ?? 0
+let yMax = samples.y.max() ?? 0
+
+let reducers: [(name: String, runs: Int, reduce: () -> [CGPoint])] = [
+    ("Douglas-Peucker (DGCharts)", 3, { DataApproximator.reduceWithDouglasPeukerN(points, resultCount: resultCount) }),
+    ("largest triangle three buckets", 10, {
+        DataApproximator.reduceWithLargestTriangleThreeBuckets(points, resultCount: resultCount)
+    }),
+    ("min/max buckets", 10, { DataApproximator.reduceWithMinMax(points, resultCount: resultCount) }),
+]
+
+for reducer in reducers {
+    var reduced: [CGPoint] = []
+    let time = Bench.measure(runs: reducer.runs) { reduced = reducer.reduce() }
+    let keepsExtremes = reduced.contains { Double($0.y) == yMin } && reduced.contains { Double($0.y) == yMax }
+    let error = String(format: "%.1f", Double(maxError(reduced)))
+    Bench.report(reducer.name, time,
+                 extra: "\(reduced.count) points, max error \(error), extremes \(keepsExtremes ? "kept" : "lost")")
+}
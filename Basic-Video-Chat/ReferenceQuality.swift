@@ -0,0 +1,203 @@
+//
+//  ReferenceQuality.swift
+//  Basic-Video-Chat
+//
+//  Full-reference quality of received synthetic frames. The publisher
+//  stamps each SyntheticPattern frame with a FrameReference in the frame
+//  metadata (see FrameStamp.swift); the subscriber rebuilds that frame's luma from it and compares
+//  it with what arrived. Both are box-downsampled before PSNR and SSIM are
+//  computed, which keeps the cost low and makes small resampling offsets
+//  matter less. A received frame at a lower resolution than the reference
+//  (the sender adapted) is scaled to the same analysis size, so the score
+//  includes what that resolution drop costs the viewer.
+//
+//  Only Foundation is used, so scoring runs the same on synthetic frames
+//  off iOS.
+//
+
+import Foundation
+
+/// Rebuilds reference frames and scores received luma against them. Buffers are kept
+/// between calls and only reallocated when the reference resolution changes.
+final class ReferenceQualityScorer {
+    /// Both frames are averaged over `downsampleFactor` x `downsampleFactor` blocks before scoring
+    let downsampleFactor: Int
+
+    private var pattern: SyntheticPattern?
+    private let referenceLuma = LumaBuffer()
+    private let referenceSmall = LumaBuffer()
+    private let receivedSmall = LumaBuffer()
+    private let receivedScaled = LumaBuffer()
+    private var receivedScaler: BilinearScaler?
+
+    init(downsampleFactor: Int = 4) {
+        self.downsampleFactor = max(1, downsampleFactor)
+    }
+
+    func score(received: LumaPlane, reference: FrameReference) -> (psnr: Double, ssim: Double) {
+        if pattern?.width != reference.width || pattern?.height != reference.height
+            || pattern?.configuration != reference.configuration {
+            pattern = SyntheticPattern(width: reference.width, height: reference.height,
+                                       configuration: reference.configuration)
+        }
+        let pattern = self.pattern!
+        let smallWidth = reference.width / downsampleFactor
+        let smallHeight = reference.height / downsampleFactor
+
+        referenceLuma.reserve(reference.width * reference.height)
+        pattern.renderLuma(frameIndex: reference.frameIndex, into: referenceLuma.pixels, stride: reference.width)
+        referenceSmall.reserve(smallWidth * smallHeight)
+        ImageQuality.boxDownsample(referenceLuma.pixels, stride: reference.width,
+                                   width: reference.width, height: reference.height, factor: downsampleFactor,
+                                   into: referenceSmall.pixels, stride: smallWidth)
+
+        // Same resolution: average the same blocks; otherwise scale up to the reference first
+        var source = received
+        if received.width != reference.width || received.height != reference.height {
+            if receivedScaler?.sourceWidth != received.width || receivedScaler?.sourceHeight != received.height
+                || receivedScaler?.destinationWidth != reference.width
+                || receivedScaler?.destinationHeight != reference.height {
+                receivedScaler = BilinearScaler(sourceWidth: received.width, sourceHeight: received.height,
+                                                destinationWidth: reference.width, destinationHeight: reference.height)
+            }
+            receivedScaled.reserve(reference.width * reference.height)
+            receivedScaler!.scale(received.pixels, stride: received.stride,
+                                  into: receivedScaled.pixels, stride: reference.width)
+            source = LumaPlane(pixels: receivedScaled.pixels, stride: reference.width,
+                               width: reference.width, height: reference.height)
+        }
+        receivedSmall.reserve(smallWidth * smallHeight)
+        ImageQuality.boxDownsample(source.pixels, stride: source.stride,
+                                   width: reference.width, height: reference.height, factor: downsampleFactor,
+                                   into: receivedSmall.pixels, stride: smallWidth)
+
+        let pixelCount = smallWidth * smallHeight
+        return (ImageQuality.psnr(receivedSmall.pixels, referenceSmall.pixels, count: pixelCount),
+                ImageQuality.ssim(receivedSmall.pixels, referenceSmall.pixels, stride: smallWidth,
+                                  width: smallWidth, height: smallHeight))
+    }
+}
+
+/// SIMD kernels on 8-bit luma.
+enum ImageQuality {
+    /// Peak signal to noise ratio in dB over `count` tightly packed pixels, capped at 100 for identical input.
+    static func psnr(_ a: UnsafePointer<UInt8>, _ b: UnsafePointer<UInt8>, count: Int) -> Double {
+        guard count > 0 else { return 0 }
+        var total: Int64 = 0
+        var lanes = SIMD8<Int32>(repeating: 0)
+        var chunks = 0
+        var i = 0
+        while i + 8 <= count {
+            let difference = SIMD8<Int32>(truncatingIfNeeded: loadVector(a + i) as SIMD8<UInt8>)
+                &- SIMD8<Int32>(truncatingIfNeeded: loadVector(b + i) as SIMD8<UInt8>)
+            lanes &+= difference &* difference
+            i += 8
+            // Flush long before 255² per step could overflow a lane
+            chunks += 1
+            if chunks == 4096 {
+                total += Int64(lanes.wrappedSum())
+                lanes = SIMD8(repeating: 0)
+                chunks = 0
+            }
+        }
+        total += Int64(lanes.wrappedSum())
+        while i < count {
+            let difference = Int64(a[i]) - Int64(b[i])
+            total += difference * difference
+            i += 1
+        }
+        let meanSquaredError = Double(total) / Double(count)
+        guard meanSquaredError > 0 else { return 100 }
+        return min(100, 10 * log10(255 * 255 / meanSquaredError))
+    }
+
+    /// Mean structural similarity over non-overlapping 8x8 windows with uniform weights.
+    static func ssim(_ a: UnsafePointer<UInt8>, _ b: UnsafePointer<UInt8>, stride: Int, width: Int, height: Int) -> Double {
+        let c1 = (0.01 * 255) * (0.01 * 255)
+        let c2 = (0.03 * 255) * (0.03 * 255)
+        var total = 0.0
+        var windows = 0
+
+        for top in Swift.stride(from: 0, through: height - 8, by: 8) {
+            for left in Swift.stride(from: 0, through: width - 8, by: 8) {
+                var sumA = SIMD8<Int32>(repeating: 0), sumB = sumA
+                var sumAA = sumA, sumBB = sumA, sumAB = sumA
+                for row in top ..< top + 8 {
+                    let x = SIMD8<Int32>(truncatingIfNeeded: loadVector(a + row * stride + left) as SIMD8<UInt8>)
+                    let y = SIMD8<Int32>(truncatingIfNeeded: loadVector(b + row * stride + left) as SIMD8<UInt8>)
+                    sumA &+= x
+                    sumB &+= y
+                    sumAA &+= x &* x
+                    sumBB &+= y &* y
+                    sumAB &+= x &* y
+                }
+                let n = 64.0
+                let meanA = Double(sumA.wrappedSum()) / n, meanB = Double(sumB.wrappedSum()) / n
+                let varianceA = Double(sumAA.wrappedSum()) / n - meanA * meanA
+                let varianceB = Double(sumBB.wrappedSum()) / n - meanB * meanB
+                let covariance = Double(sumAB.wrappedSum()) / n - meanA * meanB
+                total += ((2 * meanA * meanB + c1) * (2 * covariance + c2))
+                    / ((meanA * meanA + meanB * meanB + c1) * (varianceA + varianceB + c2))
+                windows += 1
+            }
+        }
+        return windows > 0 ? total / Double(windows) : 0
+    }
+
+    /// Averages `factor` x `factor` blocks; a partial block at the right or bottom edge is dropped.
+    static func boxDownsample(_ source: UnsafePointer<UInt8>, stride sourceStride: Int,
+                              width: Int, height: Int, factor: Int,
+                              into destination: UnsafeMutablePointer<UInt8>, stride destinationStride: Int) {
+        let outWidth = width / factor, outHeight = height / factor
+        let divisor = factor * factor
+        for outRow in 0 ..< outHeight {
+            let top = source + outRow * factor * sourceStride
+            let out = destination + outRow * destinationStride
+            var outColumn = 0
+
+            // 4x4 blocks, four at a time: sum four rows of 16 pixels, then fold neighbouring lanes twice
+            if factor == 4 {
+                while outColumn + 4 <= outWidth {
+                    var rows = SIMD16<UInt16>(repeating: 0)
+                    for row in 0 ..< 4 {
+                        rows &+= SIMD16<UInt16>(truncatingIfNeeded: loadVector(top + row * sourceStride + outColumn * 4)
+                            as SIMD16<UInt8>)
+                    }
+                    let pairs = rows.evenHalf &+ rows.oddHalf
+                    let blocks = (pairs.evenHalf &+ pairs.oddHalf &+ 8) &>> 4
+                    storeVector(SIMD4<UInt8>(truncatingIfNeeded: blocks), to: out + outColumn)
+                    outColumn += 4
+                }
+            }
+
+            while outColumn < outWidth {
+                var sum = 0
+                for row in 0 ..< factor {
+                    let line = top + row * sourceStride + outColumn * factor
+                    for column in 0 ..< factor {
+                        sum += Int(line[column])
+                    }
+                }
+                out[outColumn] = UInt8(truncatingIfNeeded: (sum + divisor / 2) / divisor)
+                outColumn += 1
+            }
+        }
+    }
+}
+
+/// A growable pixel buffer, reallocated only when it has to grow.
+private final class LumaBuffer {
+    private(set) var pixels = UnsafeMutablePointer<UInt8>.allocate(capacity: 1)
+    private var capacity = 1
+
+    deinit {
+        pixels.deallocate()
+    }
+
+    func reserve(_ count: Int) {
+        guard count > capacity else { return }
+        pixels.deallocate()
+        pixels = UnsafeMutablePointer<UInt8>.allocate(capacity: count)
+        capacity = count
+    }
+}
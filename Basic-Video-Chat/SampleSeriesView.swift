@@ -0,0 +1,80 @@
+//
+//  SampleSeriesView.swift
+//  Basic-Video-Chat
+//
+//  Read-only chart series over the samples a VideoResultSet collected.
+//  Nothing is copied up front: x is the sample timestamp in seconds and y
+//  the series' value, both computed as the visible range is read, and
+//  samples in the other QoD state are skipped with a gap in their place.
+//  Zoomed-out reads and axis bounds come from the series' pyramid, which
+//  is built while the test runs, so charts open without another pass.
+//
+
+import Foundation
+
+final class SampleSeriesView: ChartSeriesSource {
+    let series: ChartSeries
+
+    // Unowned: views are handed to charts showing this result set and never outlive it
+    private unowned let results: VideoResultSet
+    private let summary: SeriesPyramid
+
+    init(results: VideoResultSet, series: ChartSeries, summary: SeriesPyramid) {
+        self.results = results
+        self.series = series
+        self.summary = summary
+    }
+
+    // MARK: - ChartSeriesSource
+
+    var xRange: ClosedRange<Double>? {
+        return summary.xRange
+    }
+
+    func yBounds(fromX: Double, toX: Double) -> (min: Double, max: Double)? {
+        return summary.yBounds(fromX: fromX, toX: toX)
+    }
+
+    func points(fromX: Double, toX: Double, maxPoints: Int) -> (x: [Double], y: [Double]) {
+        let stats = results.qualityStats
+        let lower = max(SampleSeriesView.lowerBound(in: stats, timestamp: fromX * 1000) - 1, 0)
+        let upper = min(SampleSeriesView.lowerBound(in: stats, timestamp: toX * 1000) + 1, stats.count)
+        guard lower < upper else { return ([], []) }
+
+        // More samples than the chart can show: let the pyramid merge them
+        if upper - lower > maxPoints {
+            return summary.points(fromX: fromX, toX: toX, maxPoints: maxPoints)
+        }
+
+        var x = [Double](), y = [Double]()
+        x.reserveCapacity(upper - lower)
+        y.reserveCapacity(upper - lower)
+        var skippedOtherState = false
+        for stat in stats[lower ..< upper] {
+            guard stat.qodEnabled == series.qodEnabled else {
+                skippedOtherState = true
+                continue
+            }
+            let sampleX = stat.timestamp / 1000
+            // Same gap the pyramid records when the QoD state flips back
+            if skippedOtherState && !x.isEmpty {
+                x.append(sampleX)
+                y.append(.nan)
+            }
+            skippedOtherState = false
+            x.append(sampleX)
+            y.append(series.value(of: stat))
+        }
+        return (x, y)
+    }
+
+    /// First index whose timestamp is >= `timestamp`; samples are recorded in time order.
+    private static func lowerBound(in stats: [VideoStats], timestamp: TimeInterval) -> Int {
+        var low = 0, high = stats.count
+        while low < high {
+            let mid = (low + high) / 2
+            if stats[mid].timestamp < timestamp { low = mid + 1 } else { high = mid }
+        }
+        return low
+    }
+}
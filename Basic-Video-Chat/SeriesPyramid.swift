@@ -0,0 +1,204 @@
+//
+//  SeriesPyramid.swift
+//  Basic-Video-Chat
+//
+//  Multi-resolution min/max/mean summary of a time series. Level 0 holds the
+//  raw samples, every level above merges up to `fanout` buckets of the one
+//  below. Samples are appended incrementally, so the pyramid is ready as soon
+//  as the test ends and any zoom level can be served in O(visible buckets).
+//  Gaps split the series into segments; no bucket at any level spans one.
+//
+
+import Foundation
+
+struct SeriesBucket {
+    var xStart: Double
+    var xEnd: Double
+    var minX: Double
+    var minY: Double
+    var maxX: Double
+    var maxY: Double
+    var sum: Double
+    var count: Int
+    // First bucket after a gap, the line must not be joined to the bucket before it
+    var startsSegment: Bool = false
+
+    init(x: Double, y: Double) {
+        xStart = x
+        xEnd = x
+        minX = x
+        minY = y
+        maxX = x
+        maxY = y
+        sum = y
+        count = 1
+    }
+
+    var mean: Double { return count > 0 ? sum / Double(count) : 0 }
+
+    mutating func merge(_ other: SeriesBucket) {
+        xEnd = other.xEnd
+        if other.minY < minY {
+            minY = other.minY
+            minX = other.minX
+        }
+        if other.maxY > maxY {
+            maxY = other.maxY
+            maxX = other.maxX
+        }
+        sum += other.sum
+        count += other.count
+    }
+}
+
+final class SeriesPyramid {
+    let fanout: Int
+
+    // levels[0] is one bucket per sample, the last bucket of every upper level may still be filling
+    private(set) var levels: [[SeriesBucket]] = [[]]
+    // Children merged into the last bucket of each level, `fanout` once it is sealed
+    private var childCounts: [Int] = [0]
+    private var isGapPending = false
+    private var segmentCount = 0
+
+    init(fanout: Int = 4) {
+        precondition(fanout >= 2, "fanout must be at least 2")
+        self.fanout = fanout
+    }
+
+    var count: Int { return levels[0].count }
+    var isEmpty: Bool { return levels[0].isEmpty }
+    var xMin: Double? { return levels[0].first?.xStart }
+    var xMax: Double? { return levels[0].last?.xEnd }
+
+    func reserveCapacity(_ sampleCount: Int) {
+        levels[0].reserveCapacity(sampleCount)
+    }
+
+    /// Ends the current segment; the next sample starts a new one.
+    func appendGap() {
+        isGapPending = !isEmpty
+    }
+
+    /// Appends a sample in O(log n). `x` must not decrease between calls.
+    func append(x: Double, y: Double) {
+        var sample = SeriesBucket(x: x, y: y)
+        sample.startsSegment = isGapPending
+        if isEmpty || isGapPending {
+            segmentCount += 1
+        }
+        levels[0].append(sample)
+
+        // Walk up while each level's new child needs a new parent bucket
+        var childIsNew = true
+        for level in 1 ..< levels.count {
+            if childIsNew && (isGapPending || childCounts[level] >= fanout) {
+                levels[level].append(sample)
+                childCounts[level] = 1
+            } else {
+                levels[level][levels[level].count - 1].merge(sample)
+                if childIsNew {
+                    childCounts[level] += 1
+                }
+                childIsNew = false
+            }
+        }
+        isGapPending = false
+
+        // Grow only while some segment still has more than one top-level bucket to merge
+        if let top = levels.last, top.count > fanout, top.count > segmentCount {
+            let (level, lastChildCount) = SeriesPyramid.rebuild(top, fanout: fanout)
+            levels.append(level)
+            childCounts.append(lastChildCount)
+        }
+    }
+
+    private static func rebuild(_ below: [SeriesBucket], fanout: Int) -> ([SeriesBucket], Int) {
+        var result: [SeriesBucket] = []
+        result.reserveCapacity(below.count / fanout + 1)
+        var children = 0
+        for bucket in below {
+            if result.isEmpty || bucket.startsSegment || children == fanout {
+                result.append(bucket)
+                children = 1
+            } else {
+                result[result.count - 1].merge(bucket)
+                children += 1
+            }
+        }
+        return (result, children)
+    }
+
+    /// Lowest level whose bucket count over `[fromX, toX]` does not exceed `maxBuckets`.
+    func level(fromX: Double, toX: Double, maxBuckets: Int) -> Int {
+        guard maxBuckets > 0 else { return levels.count - 1 }
+        for level in 0 ..< levels.count {
+            let range = indexRange(level: level, fromX: fromX, toX: toX)
+            if range.count <= maxBuckets {
+                return level
+            }
+        }
+        return levels.count - 1
+    }
+
+    /// Buckets of `level` overlapping `[fromX, toX]`, plus one neighbour on each side so lines
+    /// continue past the viewport edges.
+    func buckets(level: Int, fromX: Double, toX: Double) -> ArraySlice<SeriesBucket> {
+        let range = indexRange(level: level, fromX: fromX, toX: toX)
+        return levels[level][range]
+    }
+
+    /// Convenience for the chart: picks the level for `maxBuckets` and returns its buckets.
+    func query(fromX: Double, toX: Double, maxBuckets: Int) -> (level: Int, buckets: ArraySlice<SeriesBucket>) {
+        let level = self.level(fromX: fromX, toX: toX, maxBuckets: maxBuckets)
+        return (level, buckets(level: level, fromX: fromX, toX: toX))
+    }
+
+    private func indexRange(level: Int, fromX: Double, toX: Double) -> Range<Int> {
+        let buckets = levels[level]
+        guard !buckets.isEmpty else { return 0 ..< 0 }
+
+        // First bucket ending at or after fromX, first bucket starting after toX
+        var low = 0, high = buckets.count
+        while low < high {
+            let mid = (low + high) / 2
+            if buckets[mid].xEnd < fromX { low = mid + 1 } else { high = mid }
+        }
+        let lower = max(0, low - 1)
+
+        low = lower
+        high = buckets.count
+        while low < high {
+            let mid = (low + high) / 2
+            if buckets[mid].xStart <= toX { low = mid + 1 } else { high = mid }
+        }
+        let upper = min(buckets.count, low + 1)
+
+        return lower ..< upper
+    }
+
+    /// Points tracing the visible range with about `maxPoints` vertices. Raw samples when they
+    /// fit, otherwise each bucket's min and max in x order so peaks survive decimation.
+    /// Segments are separated by a gap marker whose y is NaN.
+    func envelope(fromX: Double, toX: Double, maxPoints: Int) -> [(x: Double, y: Double)] {
+        let (level, visible) = query(fromX: fromX, toX: toX, maxBuckets: max(1, maxPoints / 2))
+        var points: [(x: Double, y: Double)] = []
+        points.reserveCapacity(level == 0 ? visible.count : visible.count * 2)
+
+        for bucket in visible {
+            if bucket.startsSegment && !points.isEmpty {
+                points.append((bucket.xStart, .nan))
+            }
+            if level == 0 || bucket.count == 1 {
+                points.append((bucket.xStart, bucket.minY))
+            } else if bucket.minX <= bucket.maxX {
+                points.append((bucket.minX, bucket.minY))
+                points.append((bucket.maxX, bucket.maxY))
+            } else {
+                points.append((bucket.maxX, bucket.maxY))
+                points.append((bucket.minX, bucket.minY))
+            }
+        }
+        return points
+    }
+}
@@ -0,0 +1,59 @@
+//
+//  main.swift
+//  SeriesPyramidBench
+//
+//  Build and query cost of SeriesPyramid, the level-of-detail summary behind
+//  the results charts:
+//
+//    swiftc -O Basic-Video-Chat/BenchSupport/BenchSupport.swift Basic-Video-Chat/SeriesPyramid.swift \
+//        Basic-Video-Chat/SeriesPyramidBench/main.swift -o series-pyramid-bench
+//    ./series-pyramid-bench [samples]
+//
+//  Reports the append cost per sample, the memory all levels take, and the
+//  time to serve a chart-width envelope for a full zoom-out, a mid zoom and
+//  a narrow window, which is what each pan or pinch asks for.
+//
+
+import Foundation
+
+let sampleCount = Bench.argument(1, default: 1_000_000)
+// A chart on a phone is about 1000 pixels wide
+let maxPoints = 1000
+
+var random = BenchRandom()
+let samples = random.series(count: sampleCount, gapEvery: 10_000)
+print("SeriesPyramid, \(sampleCount) samples, gap every 10000")
+
+var pyramid = SeriesPyramid()
+let build = Bench.measure(runs: 5) {
+    pyramid = SeriesPyramid()
+    for index in 0 ..< sampleCount {
+        if samples.y[index].isNaN {
+            pyramid.appendGap()
+        } else {
+            pyramid.append(x: samples.x[index], y: samples.y[index])
+        }
+    }
+}
+Bench.report("build", build, extra: Bench.format(seconds: build.median / Double(sampleCount)) + " per sample")
+
+let bucketCount = pyramid.levels.reduce(0) { $0 + $1.count }
+let bytes = pyramid.levels.reduce(0) { $0 + $1.capacity * MemoryLayout<SeriesBucket>.stride }
+print("levels \(pyramid.levels.count), \(bucketCount) buckets, \(Bench.format(bytes: bytes))")
+
+let xMax = samples.x[sampleCount - 1]
+let windows: [(name: String, width: Double)] = [
+    ("query full range", xMax),
+    ("query 1% of range", xMax / 100),
+    ("query 2000 samples", 1000),
+]
+for window in windows {
+    // Spread the queries over the series like panning would
+    let starts = (0 ..< 100).map { _ in Double.random(in: 0 ... max(0, xMax - window.width), using: &random) }
+    let time = Bench.measure {
+        for start in starts {
+            Bench.consume(pyramid.envelope(fromX: start, toX: start + window.width, maxPoints: maxPoints))
+        }
+    }
+    Bench.report(window.name, (time.best / 100, time.median / 100), extra: "per query")
+}
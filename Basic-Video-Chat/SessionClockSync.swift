@@ -0,0 +1,83 @@
+//
+//  SessionClockSync.swift
+//  Basic-Video-Chat
+//
+//  Keeps a ClockOffsetEstimator per remote connection by exchanging clock
+//  signals over the OTSession. Every client running this app answers pings,
+//  so both ends of a test can measure latency against the other's clock.
+//
+
+import Foundation
+import OpenTok
+
+final class SessionClockSync {
+    /// Minimum time between pings to the same connection
+    var pingInterval: TimeInterval = 2
+
+    private weak var session: OTSession?
+    // Offsets are read from renderer threads
+    private let lock = NSLock()
+    private var estimators: [String: ClockOffsetEstimator] = [:]
+    private var lastPings: [String: TimeInterval] = [:]
+
+    init(session: OTSession) {
+        self.session = session
+    }
+
+    /// Pings `connection` unless it was pinged within `pingInterval`.
+    func pingIfDue(_ connection: OTConnection) {
+        let now = Date().timeIntervalSince1970
+        lock.lock()
+        let isDue = lastPings[connection.connectionId].map { now - $0 >= pingInterval } ?? true
+        if isDue {
+            lastPings[connection.connectionId] = now
+        }
+        lock.unlock()
+
+        if isDue {
+            send(.ping(sentAt: now), to: connection)
+        }
+    }
+
+    /// Handles a received signal; returns false when it isn't part of a clock exchange.
+    @discardableResult
+    func handleSignal(type: String?, from connection: OTConnection?, string: String?) -> Bool {
+        guard let message = ClockSyncMessage(type: type, string: string) else { return false }
+        guard let connection = connection,
+              connection.connectionId != session?.connection?.connectionId else { return true }
+
+        let now = Date().timeIntervalSince1970
+        switch message {
+        case let .ping(sentAt):
+            send(.pong(sentAt: sentAt, remoteTime: now), to: connection)
+        case let .pong(sentAt, remoteTime):
+            lock.lock()
+            estimators[connection.connectionId, default: ClockOffsetEstimator()]
+                .add(sentAt: sentAt, remoteTime: remoteTime, receivedAt: now)
+            lock.unlock()
+        }
+        return true
+    }
+
+    /// The remote clock minus ours in seconds, nil until an exchange has completed
+    func offset(forConnectionId connectionId: String) -> TimeInterval? {
+        lock.lock()
+        defer { lock.unlock() }
+        return estimators[connectionId]?.offset
+    }
+
+    func remove(connectionId: String) {
+        lock.lock()
+        estimators.removeValue(forKey: connectionId)
+        lastPings.removeValue(forKey: connectionId)
+        lock.unlock()
+    }
+
+    private func send(_ message: ClockSyncMessage, to connection: OTConnection) {
+        var error: OTError?
+        session?.signal(withType: message.type, string: message.string, connection: connection, error: &error)
+        if let error = error {
+            print("Clock sync signal failed: \(error.localizedDescription)")
+        }
+    }
+}
@@ -0,0 +1,169 @@
+//
+//  SlidingMinMax.swift
+//  Basic-Video-Chat
+//
+//  Min/max bookkeeping for series that grow at the back and are trimmed at
+//  the front. MonotonicMinMax answers "bounds of everything still kept" in
+//  O(1); MinMaxSegmentTree answers bounds of an arbitrary index range in
+//  O(log n). NaN values (gap markers) are ignored by both.
+//
+
+import Foundation
+
+/// Running min and max over a sliding window, backed by two monotonic deques.
+/// Appending and removing from the front are amortized O(1).
+struct MonotonicMinMax {
+    // Indices whose values increase (minimums) / decrease (maximums) from `head` on
+    private var minimums: [(index: Int, value: Double)] = []
+    private var maximums: [(index: Int, value: Double)] = []
+    private var minHead = 0
+    private var maxHead = 0
+
+    var min: Double? { return minHead < minimums.count ? minimums[minHead].value : nil }
+    var max: Double? { return maxHead < maximums.count ? maximums[maxHead].value : nil }
+
+    mutating func append(index: Int, value: Double) {
+        guard !value.isNaN else { return }
+        while minimums.count > minHead && minimums[minimums.count - 1].value >= value {
+            minimums.removeLast()
+        }
+        minimums.append((index, value))
+        while maximums.count > maxHead && maximums[maximums.count - 1].value <= value {
+            maximums.removeLast()
+        }
+        maximums.append((index, value))
+    }
+
+    /// Forgets every value whose index is below `index`.
+    mutating func removeAll(below index: Int) {
+        while minHead < minimums.count && minimums[minHead].index < index {
+            minHead += 1
+        }
+        while maxHead < maximums.count && maximums[maxHead].index < index {
+            maxHead += 1
+        }
+        MonotonicMinMax.compact(&minimums, head: &minHead)
+        MonotonicMinMax.compact(&maximums, head: &maxHead)
+    }
+
+    /// Renumbers the stored indices after the underlying storage dropped `offset` leading values.
+    mutating func shiftIndices(by offset: Int) {
+        for i in minHead ..< minimums.count { minimums[i].index -= offset }
+        for i in maxHead ..< maximums.count { maximums[i].index -= offset }
+    }
+
+    mutating func removeAll() {
+        minimums.removeAll(keepingCapacity: true)
+        maximums.removeAll(keepingCapacity: true)
+        minHead = 0
+        maxHead = 0
+    }
+
+    // Drops consumed slots once they make up half the buffer, keeping removal amortized O(1)
+    private static func compact(_ deque: inout [(index: Int, value: Double)], head: inout Int) {
+        guard head > 32 && head * 2 > deque.count else { return }
+        deque.removeFirst(head)
+        head = 0
+    }
+}
+
+/// Bottom-up segment tree of min/max pairs for range queries over an append-only buffer.
+/// Appends are O(log n) (amortized, the leaf array doubles when full), queries O(log n).
+struct MinMaxSegmentTree {
+    private(set) var count = 0
+    private var leafCapacity = 0
+    // Node i covers nodes 2i and 2i+1; leaves start at leafCapacity
+    private var minimums: [Double] = []
+    private var maximums: [Double] = []
+
+    init() {}
+
+    init<C: Collection>(_ values: C) where C.Element == Double {
+        rebuild(values)
+    }
+
+    mutating func append(_ value: Double) {
+        if count == leafCapacity {
+            grow(to: Swift.max(16, leafCapacity * 2))
+        }
+        var node = leafCapacity + count
+        minimums[node] = value.isNaN ? .infinity : value
+        maximums[node] = value.isNaN ? -.infinity : value
+        count += 1
+
+        node /= 2
+        while node >= 1 {
+            minimums[node] = Swift.min(minimums[2 * node], minimums[2 * node + 1])
+            maximums[node] = Swift.max(maximums[2 * node], maximums[2 * node + 1])
+            node /= 2
+        }
+    }
+
+    /// Bounds of the non-NaN values in `range`, nil when there are none.
+    func bounds(in range: Range<Int>) -> (min: Double, max: Double)? {
+        let range = range.clamped(to: 0 ..< count)
+        guard !range.isEmpty else { return nil }
+
+        var low = range.lowerBound + leafCapacity
+        var high = range.upperBound + leafCapacity
+        var minValue = Double.infinity
+        var maxValue = -Double.infinity
+        while low < high {
+            if low & 1 == 1 {
+                minValue = Swift.min(minValue, minimums[low])
+                maxValue = Swift.max(maxValue, maximums[low])
+                low += 1
+            }
+            if high & 1 == 1 {
+                high -= 1
+                minValue = Swift.min(minValue, minimums[high])
+                maxValue = Swift.max(maxValue, maximums[high])
+            }
+            low /= 2
+            high /= 2
+        }
+        return minValue <= maxValue ? (minValue, maxValue) : nil
+    }
+
+    /// Replaces the contents in O(n).
+    mutating func rebuild<C: Collection>(_ values: C) where C.Element == Double {
+        count = 0
+        leafCapacity = 0
+        minimums = []
+        maximums = []
+        grow(to: Swift.max(16, values.count))
+        for value in values {
+            minimums[leafCapacity + count] = value.isNaN ? .infinity : value
+            maximums[leafCapacity + count] = value.isNaN ? -.infinity : value
+            count += 1
+        }
+        rebuildInternalNodes()
+    }
+
+    private mutating func grow(to capacity: Int) {
+        var newCapacity = 1
+        while newCapacity < capacity {
+            newCapacity *= 2
+        }
+
+        var newMinimums = [Double](repeating: .infinity, count: 2 * newCapacity)
+        var newMaximums = [Double](repeating: -.infinity, count: 2 * newCapacity)
+        if count > 0 {
+            newMinimums.replaceSubrange(newCapacity ..< newCapacity + count,
+                                        with: minimums[leafCapacity ..< leafCapacity + count])
+            newMaximums.replaceSubrange(newCapacity ..< newCapacity + count,
+                                        with: maximums[leafCapacity ..< leafCapacity + count])
+        }
+        minimums = newMinimums
+        maximums = newMaximums
+        leafCapacity = newCapacity
+        rebuildInternalNodes()
+    }
+
+    private mutating func rebuildInternalNodes() {
+        for node in stride(from: leafCapacity - 1, through: 1, by: -1) {
+            minimums[node] = Swift.min(minimums[2 * node], minimums[2 * node + 1])
+            maximums[node] = Swift.max(maximums[2 * node], maximums[2 * node + 1])
+        }
+    }
+}
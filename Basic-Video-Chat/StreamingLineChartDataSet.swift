@@ -0,0 +1,93 @@
+//
+//  StreamingLineChartDataSet.swift
+//  Basic-Video-Chat
+//
+//  ContiguousLineChartDataSet that holds only a window of a larger
+//  ChartSeriesSource. Axis bounds come from the source, so the x axis spans
+//  the whole series and autoscaling sees every point in range, while the
+//  buffers only keep the visible range (plus a margin) at about the
+//  density the screen can show. Call loadVisibleRange(...) whenever the
+//  viewport changes.
+//
+
+import Foundation
+import DGCharts
+
+class StreamingLineChartDataSet: ContiguousLineChartDataSet {
+    private(set) var source: ChartSeriesSource?
+
+    // The window in the buffers and the visible span it was loaded for
+    private var loadedRange: (fromX: Double, toX: Double, visibleSpan: Double)?
+    // Whole-series y bounds, asked from the source once
+    private var sourceBounds: (min: Double, max: Double)?
+    // Set by calcMinMaxY(fromX:toX:) for autoscaling, until the next calcMinMax()
+    private var visibleBounds: (min: Double, max: Double)?
+
+    convenience init(source: ChartSeriesSource, label: String) {
+        self.init(label: label)
+        setSource(source)
+    }
+
+    func setSource(_ source: ChartSeriesSource?) {
+        self.source = source
+        reloadSource()
+    }
+
+    /// Drops the loaded window and cached bounds, for when the source's contents changed.
+    func reloadSource() {
+        loadedRange = nil
+        sourceBounds = source?.xRange.flatMap { source?.yBounds(fromX: $0.lowerBound, toX: $0.upperBound) }
+        visibleBounds = nil
+        removeAllValues(keepingCapacity: true)
+    }
+
+    /// Loads the visible range plus one visible span on each side, at about three points per
+    /// pixel of `pixelWidth`. Returns false without touching the buffers while what's loaded
+    /// still covers the viewport and its density is within 2x of what the viewport needs.
+    @discardableResult
+    func loadVisibleRange(fromX lowestVisibleX: Double, toX highestVisibleX: Double, pixelWidth: Double) -> Bool {
+        guard let source = source, pixelWidth > 0 else { return false }
+        let visibleSpan = highestVisibleX - lowestVisibleX
+
+        if let loaded = loadedRange,
+           loaded.fromX <= lowestVisibleX,
+           loaded.toX >= highestVisibleX,
+           visibleSpan > loaded.visibleSpan / 2,
+           visibleSpan < loaded.visibleSpan * 2 {
+            return false
+        }
+
+        let fromX = lowestVisibleX - visibleSpan
+        let toX = highestVisibleX + visibleSpan
+        let points = source.points(fromX: fromX, toX: toX, maxPoints: Int(pixelWidth) * 3)
+        replaceValues(x: points.x, y: points.y)
+        loadedRange = (fromX, toX, visibleSpan)
+        return true
+    }
+
+    // MARK: - Bounds
+
+    override var xMin: Double { return source?.xRange?.lowerBound ?? super.xMin }
+    override var xMax: Double { return source?.xRange?.upperBound ?? super.xMax }
+    override var yMin: Double { return visibleBounds?.min ?? sourceBounds?.min ?? super.yMin }
+    override var yMax: Double { return visibleBounds?.max ?? sourceBounds?.max ?? super.yMax }
+
+    override func calcMinMax() {
+        visibleBounds = nil
+        super.calcMinMax()
+    }
+
+    override func calcMinMaxY(fromX: Double, toX: Double) {
+        super.calcMinMaxY(fromX: fromX, toX: toX)
+        visibleBounds = source?.yBounds(fromX: fromX, toX: toX)
+    }
+
+    override func copy(with zone: NSZone? = nil) -> Any {
+        let copy = super.copy(with: zone) as! StreamingLineChartDataSet
+        copy.source = source
+        copy.loadedRange = loadedRange
+        copy.sourceBounds = sourceBounds
+        copy.visibleBounds = visibleBounds
+        return copy
+    }
+}
@@ -0,0 +1,240 @@
+//
+//  SubscriberGridView.swift
+//  Basic-Video-Chat
+//
+//  Virtualized grid of subscriber tiles for large sessions. Tiles are
+//  collection view cells, so only the cells on screen (plus the few the
+//  collection view keeps for reuse) exist at any time, each with one
+//  SubscriberRenderView. A subscriber's frames reach the grid through its
+//  SubscriberVideoRouter, which points at the render view of the cell that
+//  currently shows the subscriber, or nowhere while it is scrolled away.
+//  Per participant the grid only keeps a stream ID and a router, so memory
+//  doesn't grow with the number of tiles that are not visible.
+//
+//  Stream changes are applied as insertions and deletions, so cells of
+//  streams that stay keep their render view and picture.
+//
+
+import UIKit
+import OpenTok
+
+/// Forwards one subscriber's frames to the render view showing it, if any. Frames arrive on
+/// the subscriber's render thread while cells bind and unbind on the main thread.
+final class SubscriberVideoRouter: NSObject, OTVideoRender {
+    private let lock = NSLock()
+    private weak var target: SubscriberRenderView?
+
+    func attach(_ view: SubscriberRenderView) {
+        lock.lock()
+        target = view
+        lock.unlock()
+    }
+
+    /// Stops forwarding to `view`; no effect when another view took over already.
+    func detach(_ view: SubscriberRenderView) {
+        lock.lock()
+        if target === view {
+            target = nil
+        }
+        lock.unlock()
+    }
+
+    func renderVideoFrame(_ frame: OTVideoFrame) {
+        lock.lock()
+        let target = self.target
+        lock.unlock()
+        target?.display(frame)
+    }
+}
+
+final class SubscriberGridView: UIView, UICollectionViewDataSource, UICollectionViewDelegate {
+    /// Rows of tiles; the grid scrolls horizontally through the columns
+    var rows = 2 {
+        didSet { setNeedsLayout() }
+    }
+    var tileSpacing: CGFloat = 4 {
+        didSet { setNeedsLayout() }
+    }
+    /// Width over height of a tile
+    var tileAspectRatio: CGFloat = 4 / 3 {
+        didSet { setNeedsLayout() }
+    }
+    /// Called whenever the visible tiles may have changed
+    var onVisibleTilesChange: (() -> Void)?
+
+    /// Streams in tile order
+    private(set) var streamIds: [String] = []
+
+    private let flowLayout = UICollectionViewFlowLayout()
+    private let collectionView: UICollectionView
+    private var routers: [String: SubscriberVideoRouter] = [:]
+
+    override init(frame: CGRect) {
+        flowLayout.scrollDirection = .horizontal
+        collectionView = UICollectionView(frame: CGRect(origin: .zero, size: frame.size), collectionViewLayout: flowLayout)
+        super.init(frame: frame)
+        setupCollectionView()
+    }
+
+    required init?(coder aDecoder: NSCoder) {
+        flowLayout.scrollDirection = .horizontal
+        collectionView = UICollectionView(frame: .zero, collectionViewLayout: flowLayout)
+        super.init(coder: aDecoder)
+        setupCollectionView()
+    }
+
+    private func setupCollectionView() {
+        collectionView.backgroundColor = .clear
+        collectionView.showsHorizontalScrollIndicator = true
+        collectionView.showsVerticalScrollIndicator = false
+        collectionView.register(SubscriberGridCell.self, forCellWithReuseIdentifier: SubscriberGridCell.reuseIdentifier)
+        collectionView.dataSource = self
+        collectionView.delegate = self
+        addSubview(collectionView)
+    }
+
+    override func layoutSubviews() {
+        super.layoutSubviews()
+        collectionView.frame = bounds
+
+        let rowCount = CGFloat(max(1, rows))
+        let tileHeight = max(1, (bounds.height - tileSpacing * (rowCount - 1)) / rowCount)
+        let tileSize = CGSize(width: tileHeight * tileAspectRatio, height: tileHeight)
+        if flowLayout.itemSize != tileSize || flowLayout.minimumLineSpacing != tileSpacing {
+            flowLayout.itemSize = tileSize
+            flowLayout.minimumLineSpacing = tileSpacing
+            flowLayout.minimumInteritemSpacing = tileSpacing
+            flowLayout.invalidateLayout()
+        }
+        onVisibleTilesChange?()
+    }
+
+    // MARK: - Streams
+
+    /// The router to put behind a subscriber's renderer so its frames reach the grid.
+    func router(for streamId: String) -> SubscriberVideoRouter {
+        if let router = routers[streamId] {
+            return router
+        }
+        let router = SubscriberVideoRouter()
+        routers[streamId] = router
+        return router
+    }
+
+    /// Shows `newStreamIds` in that order, inserting and deleting only the tiles that changed.
+    func setStreamIds(_ newStreamIds: [String]) {
+        let kept = Set(newStreamIds)
+        // Also drops routers of streams that left before they were ever shown
+        routers = routers.filter { kept.contains($0.key) }
+        guard newStreamIds != streamIds else { return }
+
+        let oldStreamIds = streamIds
+        let previous = Set(oldStreamIds)
+        // A plain insert/delete diff only holds while the remaining tiles keep their order
+        guard window != nil, oldStreamIds.filter(kept.contains) == newStreamIds.filter(previous.contains) else {
+            streamIds = newStreamIds
+            collectionView.reloadData()
+            return
+        }
+
+        let deleted = oldStreamIds.indices.filter { !kept.contains(oldStreamIds[$0]) }
+        let inserted = newStreamIds.indices.filter { !previous.contains(newStreamIds[$0]) }
+        collectionView.performBatchUpdates({
+            streamIds = newStreamIds
+            collectionView.deleteItems(at: deleted.map { IndexPath(item: $0, section: 0) })
+            collectionView.insertItems(at: inserted.map { IndexPath(item: $0, section: 0) })
+        }, completion: { [weak self] _ in
+            self?.onVisibleTilesChange?()
+        })
+    }
+
+    /// Size of one tile as of the last layout pass
+    var tileSize: CGSize {
+        return flowLayout.itemSize
+    }
+
+    /// Frames of all tiles in the collection view's content coordinates, laid out or not.
+    var tileFrames: [String: CGRect] {
+        var frames: [String: CGRect] = [:]
+        for (index, streamId) in streamIds.enumerated() {
+            if let attributes = collectionView.layoutAttributesForItem(at: IndexPath(item: index, section: 0)) {
+                frames[streamId] = attributes.frame
+            }
+        }
+        return frames
+    }
+
+    /// The part of the content that is on screen, in the same coordinates as `tileFrames`
+    var visibleBounds: CGRect {
+        return collectionView.bounds
+    }
+
+    // MARK: - UICollectionViewDataSource
+
+    func collectionView(_ collectionView: UICollectionView, numberOfItemsInSection section: Int) -> Int {
+        return streamIds.count
+    }
+
+    func collectionView(_ collectionView: UICollectionView, cellForItemAt indexPath: IndexPath) -> UICollectionViewCell {
+        let cell = collectionView.dequeueReusableCell(withReuseIdentifier: SubscriberGridCell.reuseIdentifier,
+                                                      for: indexPath)
+        (cell as? SubscriberGridCell)?.router = router(for: streamIds[indexPath.item])
+        return cell
+    }
+
+    // MARK: - UICollectionViewDelegate
+
+    func scrollViewDidScroll(_ scrollView: UIScrollView) {
+        onVisibleTilesChange?()
+    }
+
+    func collectionView(_ collectionView: UICollectionView, willDisplay cell: UICollectionViewCell,
+                        forItemAt indexPath: IndexPath) {
+        // Prefetched cells can come back on screen without another cellForItemAt
+        (cell as? SubscriberGridCell)?.router = router(for: streamIds[indexPath.item])
+    }
+
+    func collectionView(_ collectionView: UICollectionView, didEndDisplaying cell: UICollectionViewCell,
+                        forItemAt indexPath: IndexPath) {
+        // Off-screen cells stop drawing right away, even before they are reused
+        (cell as? SubscriberGridCell)?.router = nil
+    }
+}
+
+/// A grid tile: one render view, fed by whichever router the cell is bound to.
+private final class SubscriberGridCell: UICollectionViewCell {
+    static let reuseIdentifier = "SubscriberGridCell"
+
+    private let renderView = SubscriberRenderView()
+
+    var router: SubscriberVideoRouter? {
+        didSet {
+            guard router !== oldValue else { return }
+            oldValue?.detach(renderView)
+            renderView.clear()
+            router?.attach(renderView)
+        }
+    }
+
+    override init(frame: CGRect) {
+        super.init(frame: frame)
+        setupRenderView()
+    }
+
+    required init?(coder aDecoder: NSCoder) {
+        super.init(coder: aDecoder)
+        setupRenderView()
+    }
+
+    private func setupRenderView() {
+        renderView.frame = contentView.bounds
+        renderView.autoresizingMask = [.flexibleWidth, .flexibleHeight]
+        renderView.layer.cornerRadius = 4
+        contentView.addSubview(renderView)
+    }
+
+    override func prepareForReuse() {
+        super.prepareForReuse()
+        router = nil
+    }
+}
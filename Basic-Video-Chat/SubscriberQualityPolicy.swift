@@ -0,0 +1,238 @@
+//
+//  SubscriberQualityPolicy.swift
+//  Basic-Video-Chat
+//
+//  Picks a preferred resolution and frame rate for every subscriber, so the
+//  downlink is spent on the video people can actually see:
+//
+//  - each subscriber wants the lowest ladder level whose resolution covers
+//    its tile in pixels, one level less when it is mostly scrolled away, and
+//    the bottom level when it is off-screen,
+//  - when the wanted levels don't fit the measured downlink, the subscriber
+//    paying the most per visible share steps down first, until they fit,
+//  - a new level only takes effect once it has been wanted for a few ticks
+//    in a row, longer for upgrades than for downgrades, so scrolling and
+//    bitrate noise don't make streams flap between layers.
+//
+//  Driven by the stats timer: record inbound counters as RTC stats arrive,
+//  then call update(_:) once per tick. Not thread safe, use it on one queue.
+//
+
+import Foundation
+import CoreGraphics
+
+/// What a subscriber's tile looks like on one tick.
+struct SubscriberViewport {
+    /// Tile size in pixels
+    var tileSize: CGSize
+    /// Share of the tile inside the visible part of its scroll view, 0 ... 1
+    var visibleFraction: Double
+}
+
+/// A preferred resolution and frame rate, one step of the policy's ladder.
+struct SubscriberQualityLevel: Equatable {
+    let resolution: CGSize
+    let frameRate: Float
+    /// Rough bitrate of a simulcast layer at this level
+    let estimatedKbps: Double
+}
+
+/// Downlink capacity from receive-side stats. WebRTC's available incoming bitrate is used
+/// when the stats carry it; otherwise the rate that got through while losing packets is
+/// taken as the ceiling, and raised slowly again while the downlink is clean.
+struct DownlinkEstimate {
+    /// Loss ratio at which the downlink counts as saturated
+    var congestionLoss = 0.05
+    /// Growth per clean update once a ceiling is known
+    var recoveryFactor = 1.05
+
+    /// nil until the downlink has shown a limit
+    private(set) var capacityKbps: Double?
+
+    mutating func update(receivedKbps: Double, lossRatio: Double, availableKbps: Double?) {
+        if let available = availableKbps, available > 0 {
+            capacityKbps = capacityKbps.map { 0.7 * $0 + 0.3 * available } ?? available
+        } else if lossRatio >= congestionLoss {
+            capacityKbps = min(capacityKbps ?? receivedKbps, receivedKbps)
+        } else if let capacity = capacityKbps, lossRatio < congestionLoss / 5 {
+            capacityKbps = capacity * recoveryFactor
+        }
+    }
+}
+
+final class SubscriberQualityPolicy {
+    /// Levels from cheapest to richest, using the frame rates scalable video offers
+    static let ladder = [
+        SubscriberQualityLevel(resolution: CGSize(width: 160, height: 120), frameRate: 7, estimatedKbps: 60),
+        SubscriberQualityLevel(resolution: CGSize(width: 320, height: 240), frameRate: 7, estimatedKbps: 150),
+        SubscriberQualityLevel(resolution: CGSize(width: 320, height: 240), frameRate: 15, estimatedKbps: 250),
+        SubscriberQualityLevel(resolution: CGSize(width: 640, height: 480), frameRate: 15, estimatedKbps: 500),
+        SubscriberQualityLevel(resolution: CGSize(width: 640, height: 480), frameRate: 30, estimatedKbps: 800),
+        SubscriberQualityLevel(resolution: CGSize(width: 1280, height: 720), frameRate: 30, estimatedKbps: 1500),
+        SubscriberQualityLevel(resolution: CGSize(width: 1920, height: 1080), frameRate: 30, estimatedKbps: 2500),
+    ]
+
+    /// Share of the downlink estimate the levels may use
+    var headroom = 0.85
+    /// Ticks a higher level has to stay wanted before switching to it
+    var upgradeHoldTicks = 4
+    /// Ticks a lower level has to stay wanted before switching to it
+    var downgradeHoldTicks = 2
+    /// Below this visible share a subscriber wants one level less
+    var partialVisibility = 0.5
+
+    private(set) var downlink = DownlinkEstimate()
+
+    private struct State {
+        // Index into the ladder, nil until the first update
+        var current: Int?
+        var pending: Int?
+        var pendingTicks = 0
+        var inbound: InboundCounters?
+        var receivedKbps = 0.0
+        var lossRatio = 0.0
+    }
+
+    private struct InboundCounters {
+        var timestampMs: Double
+        var bytesReceived: UInt64
+        var packetsReceived: UInt64
+        var packetsLost: UInt64
+    }
+
+    private var states: [String: State] = [:]
+    private var availableIncomingKbps: Double?
+
+    /// Video bitrate received over all subscribers in the latest reports
+    var receivedKbps: Double {
+        return states.values.reduce(0) { $0 + $1.receivedKbps }
+    }
+
+    /// Current level of `streamId`, nil before its first update.
+    func level(forStreamId streamId: String) -> SubscriberQualityLevel? {
+        return states[streamId]?.current.map { SubscriberQualityPolicy.ladder[$0] }
+    }
+
+    /// Feeds one inbound-rtp video report. Rates are taken over the interval since the last one.
+    func recordInbound(streamId: String, timestampMs: Double, bytesReceived: UInt64,
+                       packetsReceived: UInt64, packetsLost: UInt64) {
+        var state = states[streamId] ?? State()
+        let counters = InboundCounters(timestampMs: timestampMs, bytesReceived: bytesReceived,
+                                       packetsReceived: packetsReceived, packetsLost: packetsLost)
+        if let last = state.inbound, timestampMs > last.timestampMs,
+           bytesReceived >= last.bytesReceived, packetsReceived >= last.packetsReceived,
+           packetsLost >= last.packetsLost {
+            let received = Double(packetsReceived - last.packetsReceived)
+            let lost = Double(packetsLost - last.packetsLost)
+            state.receivedKbps = Double(bytesReceived - last.bytesReceived) * 8 / (timestampMs - last.timestampMs)
+            state.lossRatio = received + lost > 0 ? lost / (received + lost) : 0
+        }
+        state.inbound = counters
+        states[streamId] = state
+    }
+
+    /// Feeds the transport's available incoming bitrate, when the stats report one.
+    func recordAvailableIncoming(kbps: Double) {
+        availableIncomingKbps = kbps
+    }
+
+    func remove(streamId: String) {
+        states.removeValue(forKey: streamId)
+    }
+
+    func removeAll() {
+        states.removeAll()
+        availableIncomingKbps = nil
+        downlink = DownlinkEstimate()
+    }
+
+    /// Runs one tick over the subscribers in `viewports` and returns the ones whose level changed.
+    func update(_ viewports: [String: SubscriberViewport]) -> [String: SubscriberQualityLevel] {
+        updateDownlink()
+
+        var targets = viewports.mapValues { wantedLevel(for: $0) }
+        fitToDownlink(&targets, viewports: viewports)
+
+        var changes: [String: SubscriberQualityLevel] = [:]
+        for (streamId, target) in targets {
+            var state = states[streamId] ?? State()
+            if applyHysteresis(target: target, to: &state) {
+                changes[streamId] = SubscriberQualityPolicy.ladder[target]
+            }
+            states[streamId] = state
+        }
+        return changes
+    }
+
+    // MARK: - Policy
+
+    private func updateDownlink() {
+        let received = receivedKbps
+        // Loss weighted by how much each stream carries
+        let lost = states.values.reduce(0) { $0 + $1.receivedKbps * $1.lossRatio }
+        guard received > 0 || availableIncomingKbps != nil else { return }
+        downlink.update(receivedKbps: received, lossRatio: received > 0 ? lost / received : 0,
+                        availableKbps: availableIncomingKbps)
+        availableIncomingKbps = nil
+    }
+
+    private func wantedLevel(for viewport: SubscriberViewport) -> Int {
+        guard viewport.visibleFraction > 0 else { return 0 }
+        let ladder = SubscriberQualityPolicy.ladder
+        // Richest level at the smallest resolution that covers the tile
+        let covering = ladder.first {
+            $0.resolution.width >= viewport.tileSize.width && $0.resolution.height >= viewport.tileSize.height
+        }?.resolution ?? ladder[ladder.count - 1].resolution
+        let wanted = ladder.lastIndex { $0.resolution == covering } ?? ladder.count - 1
+        return viewport.visibleFraction < partialVisibility ? max(0, wanted - 1) : wanted
+    }
+
+    private func fitToDownlink(_ targets: inout [String: Int], viewports: [String: SubscriberViewport]) {
+        guard let capacity = downlink.capacityKbps else { return }
+        let ladder = SubscriberQualityPolicy.ladder
+        let budget = capacity * headroom
+        var total = targets.values.reduce(0) { $0 + ladder[$1].estimatedKbps }
+
+        while total > budget {
+            // The most expensive stream per share of it that is seen
+            let candidate = targets.filter { $0.value > 0 }.max { lhs, rhs in
+                cost(of: lhs.value, visibleFraction: viewports[lhs.key]?.visibleFraction ?? 0)
+                    < cost(of: rhs.value, visibleFraction: viewports[rhs.key]?.visibleFraction ?? 0)
+            }
+            guard let step = candidate else { break }
+            targets[step.key] = step.value - 1
+            total -= ladder[step.value].estimatedKbps - ladder[step.value - 1].estimatedKbps
+        }
+    }
+
+    private func cost(of index: Int, visibleFraction: Double) -> Double {
+        return SubscriberQualityPolicy.ladder[index].estimatedKbps / max(visibleFraction, 0.01)
+    }
+
+    /// Moves `state` towards `target`; true when its current level changed.
+    private func applyHysteresis(target: Int, to state: inout State) -> Bool {
+        guard let current = state.current else {
+            state.current = target
+            return true
+        }
+        guard target != current else {
+            state.pending = nil
+            state.pendingTicks = 0
+            return false
+        }
+
+        // Ticks count as long as the wanted level stays on the same side of the current one
+        if let pending = state.pending, (pending > current) == (target > current) {
+            state.pendingTicks += 1
+        } else {
+            state.pendingTicks = 1
+        }
+        state.pending = target
+
+        guard state.pendingTicks >= (target > current ? upgradeHoldTicks : downgradeHoldTicks) else { return false }
+        state.current = target
+        state.pending = nil
+        state.pendingTicks = 0
+        return true
+    }
+}
@@ -0,0 +1,249 @@
+//
+//  SubscriberRenderView.swift
+//  Basic-Video-Chat
+//
+//  Lightweight video view for the subscriber grid. Unlike an OTSubscriber's
+//  own view it isn't tied to one subscriber: grid cells keep one each and
+//  point a subscriber's frames at it while the cell shows that subscriber.
+//
+//  Frames are converted on the thread that delivers them. I420 frames are
+//  first scaled down to the view's pixel size, so a 1080p stream in a small
+//  tile costs a tile's worth of memory. The BGRA result lives in a pooled
+//  buffer that goes back to its PlaneBufferPool when Core Animation lets go
+//  of the image. The main thread only swaps layer contents. While one frame
+//  is on its way to the screen, newer ones are dropped, and nothing is drawn
+//  before the view knows its size.
+//
+//  Each view owns its pools instead of using the shared ones: tile and frame
+//  sizes change as layout and the subscriber's resolution do, and a shared
+//  pool per size would live forever. A pool is replaced when the size
+//  changes and freed once the images leasing its buffers are gone.
+//
+
+import UIKit
+import OpenTok
+
+final class SubscriberRenderView: UIView {
+    private let contentLayer = CALayer()
+
+    private let lock = NSLock()
+    // Guarded by `lock`
+    private var isDisplayPending = false
+    private var generation = 0
+    private var pixelSize = CGSize.zero
+    // Main thread only
+    private var currentRotation = PlaneRotation.none
+
+    // Only touched by the one display(_:) call that isn't dropped
+    private var scaler: I420Scaler?
+    private var scalerDimensions = (sourceWidth: 0, sourceHeight: 0, width: 0, height: 0)
+    private var imagePool: PlaneBufferPool?
+    private var scratchPool: PlaneBufferPool?
+
+    /// Images alive at once: the layer's contents, the one Core Animation may still be
+    /// committing, and the one being converted
+    private static let imageSlotCount = 3
+
+    override init(frame: CGRect) {
+        super.init(frame: frame)
+        setupLayer()
+    }
+
+    required init?(coder aDecoder: NSCoder) {
+        super.init(coder: aDecoder)
+        setupLayer()
+    }
+
+    private func setupLayer() {
+        backgroundColor = .black
+        clipsToBounds = true
+        contentLayer.contentsGravity = .resizeAspectFill
+        contentLayer.actions = ["contents": NSNull(), "bounds": NSNull(), "position": NSNull(), "transform": NSNull()]
+        layer.addSublayer(contentLayer)
+    }
+
+    override func layoutSubviews() {
+        super.layoutSubviews()
+        lock.lock()
+        pixelSize = CGSize(width: bounds.width * contentScaleFactor, height: bounds.height * contentScaleFactor)
+        lock.unlock()
+        layoutContentLayer(rotation: currentRotation)
+    }
+
+    /// Drops the current picture and any frame still being converted, e.g. before showing another stream.
+    func clear() {
+        lock.lock()
+        generation += 1
+        lock.unlock()
+        contentLayer.contents = nil
+    }
+
+    /// Shows `frame`. Can be called from any thread.
+    func display(_ frame: OTVideoFrame) {
+        lock.lock()
+        guard !isDisplayPending else {
+            lock.unlock()
+            return
+        }
+        // Not laid out yet, the frame's size would be all there is to go by
+        guard pixelSize.width > 0, pixelSize.height > 0 else {
+            lock.unlock()
+            return
+        }
+        isDisplayPending = true
+        let generation = self.generation
+        let pixelSize = self.pixelSize
+        lock.unlock()
+
+        // Quarter turns show the frame's width along the view's height
+        let rotation = PlaneRotation(uprighting: frame.orientation)
+        let image = makeImage(frame, fillingPixelSize: rotation.swapsDimensions
+            ? CGSize(width: pixelSize.height, height: pixelSize.width) : pixelSize)
+
+        DispatchQueue.main.async { [weak self] in
+            guard let self = self else { return }
+            self.lock.lock()
+            self.isDisplayPending = false
+            let isCurrent = generation == self.generation
+            self.lock.unlock()
+            guard isCurrent, let image = image else { return }
+
+            self.contentLayer.contents = image
+            if rotation != self.currentRotation {
+                self.currentRotation = rotation
+                self.layoutContentLayer(rotation: rotation)
+            }
+        }
+    }
+
+    // MARK: - Layout
+
+    /// Turns the content layer so the picture is upright; quarter turns swap its bounds to match.
+    private func layoutContentLayer(rotation: PlaneRotation) {
+        let quarterTurns: CGFloat
+        switch rotation {
+        case .none: quarterTurns = 0
+        case .clockwise90: quarterTurns = 1
+        case .clockwise180: quarterTurns = 2
+        case .clockwise270: quarterTurns = 3
+        }
+        let size = rotation.swapsDimensions ? CGSize(width: bounds.height, height: bounds.width) : bounds.size
+        contentLayer.bounds = CGRect(origin: .zero, size: size)
+        contentLayer.position = CGPoint(x: bounds.midX, y: bounds.midY)
+        contentLayer.setAffineTransform(CGAffineTransform(rotationAngle: quarterTurns * .pi / 2))
+    }
+
+    // MARK: - Conversion
+
+    private func makeImage(_ frame: OTVideoFrame, fillingPixelSize pixelSize: CGSize) -> CGImage? {
+        guard frame.width > 0, frame.height > 0 else { return nil }
+
+        if let planes = frame.i420Planes {
+            let (width, height) = SubscriberRenderView.scaledDimensions(width: frame.width, height: frame.height,
+                                                                        filling: pixelSize)
+            if width == frame.width && height == frame.height {
+                return makeImage(width: width, height: height) { argb in
+                    PixelFormatConversion.convert(planes, to: argb, width: width, height: height)
+                }
+            }
+
+            // Scale first so conversion and the image only cover the tile's pixels
+            let scratchLayout = PlaneBufferLayout(width: width, height: height, pixelFormat: .i420)
+            let scratchPool = SubscriberRenderView.pool(&self.scratchPool, for: scratchLayout, slotCount: 1)
+            let scratch = scratchPool.acquire()
+            defer { scratchPool.release(scratch) }
+            guard let scaled = scratch.i420Planes else { return nil }
+            scaler(sourceWidth: frame.width, sourceHeight: frame.height, width: width, height: height)
+                .scale(planes, into: scaled)
+            return makeImage(width: width, height: height) { argb in
+                PixelFormatConversion.convert(scaled, to: argb, width: width, height: height)
+            }
+        }
+        if let planes = frame.nv12Planes {
+            return makeImage(width: frame.width, height: frame.height) { argb in
+                PixelFormatConversion.convert(planes, to: argb, width: frame.width, height: frame.height)
+            }
+        }
+        if let source = frame.argbPlane {
+            return makeImage(width: frame.width, height: frame.height) { argb in
+                PixelFormatConversion.copyPlane(source.pixels, stride: source.stride, to: argb.pixels, stride: argb.stride,
+                                                rowBytes: frame.width * 4, rows: frame.height)
+            }
+        }
+        return nil
+    }
+
+    private func scaler(sourceWidth: Int, sourceHeight: Int, width: Int, height: Int) -> I420Scaler {
+        let dimensions = (sourceWidth: sourceWidth, sourceHeight: sourceHeight, width: width, height: height)
+        if let scaler = scaler, scalerDimensions == dimensions {
+            return scaler
+        }
+        let scaler = I420Scaler(sourceWidth: sourceWidth, sourceHeight: sourceHeight,
+                                destinationWidth: width, destinationHeight: height)
+        self.scaler = scaler
+        scalerDimensions = dimensions
+        return scaler
+    }
+
+    /// The pool in `cached` when it has `layout`, otherwise a new one that replaces it.
+    private static func pool(_ cached: inout PlaneBufferPool?, for layout: PlaneBufferLayout, slotCount: Int) -> PlaneBufferPool {
+        if let pool = cached, pool.layout == layout {
+            return pool
+        }
+        let pool = PlaneBufferPool(layout: layout, slotCount: slotCount)
+        cached = pool
+        return pool
+    }
+
+    /// Largest even size at or below the frame's that still covers `pixelSize` at the frame's aspect ratio.
+    private static func scaledDimensions(width: Int, height: Int, filling pixelSize: CGSize) -> (Int, Int) {
+        guard pixelSize.width > 0, pixelSize.height > 0 else { return (width, height) }
+        let factor = min(1, max(Double(pixelSize.width) / Double(width), Double(pixelSize.height) / Double(height)))
+        guard factor < 1 else { return (width, height) }
+        return (max(2, Int((Double(width) * factor).rounded(.up)) & ~1),
+                max(2, Int((Double(height) * factor).rounded(.up)) & ~1))
+    }
+
+    /// A BGRA image over a pooled buffer that `fill` writes. The buffer returns to its pool with the image.
+    private func makeImage(width: Int, height: Int, fill: (ARGBPlane) -> Void) -> CGImage? {
+        let layout = PlaneBufferLayout(width: width, height: height, pixelFormat: .argb)
+        let pool = SubscriberRenderView.pool(&imagePool, for: layout, slotCount: SubscriberRenderView.imageSlotCount)
+        let buffer = pool.acquire()
+        guard let argb = buffer.argbPlane else {
+            pool.release(buffer)
+            return nil
+        }
+        fill(argb)
+
+        let lease = Unmanaged.passRetained(PooledImageBuffer(pool: pool, buffer: buffer))
+        guard let provider = CGDataProvider(dataInfo: lease.toOpaque(), data: buffer.bytes,
+                                            size: buffer.layout.byteCount,
+                                            releaseData: { info, _, _ in
+                                                guard let info = info else { return }
+                                                Unmanaged<PooledImageBuffer>.fromOpaque(info).takeRetainedValue().release()
+                                            }) else {
+            lease.takeRetainedValue().release()
+            return nil
+        }
+        // B, G, R, A in memory is a little-endian 32-bit pixel with alpha first
+        let bitmapInfo = CGBitmapInfo(rawValue: CGBitmapInfo.byteOrder32Little.rawValue | CGImageAlphaInfo.noneSkipFirst.rawValue)
+        return CGImage(width: width, height: height, bitsPerComponent: 8, bitsPerPixel: 32,
+                       bytesPerRow: argb.stride, space: CGColorSpaceCreateDeviceRGB(), bitmapInfo: bitmapInfo,
+                       provider: provider, decode: nil, shouldInterpolate: true, intent: .defaultIntent)
+    }
+}
+
+/// Hands an image's pixels back to their pool once Core Animation releases the image.
+private final class PooledImageBuffer {
+    private let pool: PlaneBufferPool
+    private let buffer: PlaneBuffer
+
+    init(pool: PlaneBufferPool, buffer: PlaneBuffer) {
+        self.pool = pool
+        self.buffer = buffer
+    }
+
+    func release() {
+        pool.release(buffer)
+    }
+}
@@ -0,0 +1,73 @@
+//
+//  SubscriberTileLayout.swift
+//  Basic-Video-Chat
+//
+//  Stable left-to-right order of subscriber tiles in a horizontal strip.
+//  Tiles keep the order streams joined in; a leaving stream closes its gap
+//  by shifting the tiles after it. Layout passes are incremental: the
+//  layout remembers the frame it last handed out per tile and only returns
+//  tiles that are new or have to move, so callers never re-attach a view
+//  that stays where it is.
+//
+
+import Foundation
+import CoreGraphics
+
+final class SubscriberTileLayout {
+    var tileSize: CGSize = .zero {
+        didSet {
+            if tileSize != oldValue { appliedFrames.removeAll() }
+        }
+    }
+    var spacing: CGFloat = 0 {
+        didSet {
+            if spacing != oldValue { appliedFrames.removeAll() }
+        }
+    }
+
+    /// Streams in tile order
+    private(set) var streamIds: [String] = []
+    private var appliedFrames: [String: CGRect] = [:]
+
+    /// Adds a tile after the existing ones; no effect when `streamId` is already laid out.
+    func insert(_ streamId: String) {
+        guard !streamIds.contains(streamId) else { return }
+        streamIds.append(streamId)
+    }
+
+    func remove(_ streamId: String) {
+        guard let index = streamIds.firstIndex(of: streamId) else { return }
+        streamIds.remove(at: index)
+        appliedFrames.removeValue(forKey: streamId)
+    }
+
+    func removeAll() {
+        streamIds.removeAll()
+        appliedFrames.removeAll()
+    }
+
+    func frame(at index: Int) -> CGRect {
+        return CGRect(x: CGFloat(index) * (tileSize.width + spacing), y: 0,
+                      width: tileSize.width, height: tileSize.height)
+    }
+
+    /// Size of the strip, with trailing spacing after the last tile
+    var contentSize: CGSize {
+        let width = streamIds.isEmpty ? 0 : frame(at: streamIds.count - 1).maxX + spacing
+        return CGSize(width: width, height: tileSize.height)
+    }
+
+    /// Tiles that are new or whose frame changed since the last call, in tile order.
+    /// The returned frames count as applied.
+    func pendingFrames() -> [(streamId: String, frame: CGRect)] {
+        var pending: [(streamId: String, frame: CGRect)] = []
+        for (index, streamId) in streamIds.enumerated() {
+            let frame = self.frame(at: index)
+            if appliedFrames[streamId] != frame {
+                appliedFrames[streamId] = frame
+                pending.append((streamId, frame))
+            }
+        }
+        return pending
+    }
+}
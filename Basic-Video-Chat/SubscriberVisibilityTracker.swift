@@ -0,0 +1,80 @@
+//
+//  SubscriberVisibilityTracker.swift
+//  Basic-Video-Chat
+//
+//  Decides which subscriber tiles in a scroll view should receive video.
+//  A tile that leaves the visible bounds keeps its video for a grace period,
+//  so a quick scroll back doesn't show a frozen tile, and is paused after
+//  that. Video resumes as soon as a tile comes within `prefetchMargin` of
+//  the visible bounds, so the stream has time to restart before the tile
+//  scrolls into view.
+//
+//  Feed it on every scroll and on a timer, since grace periods also run
+//  out while nothing moves. Not thread safe, use it on one queue.
+//
+
+import Foundation
+import CoreGraphics
+
+final class SubscriberVisibilityTracker {
+    /// How long a tile stays out of range before its video is paused
+    var gracePeriod: TimeInterval
+    /// Distance beyond the visible bounds at which a tile counts as approaching
+    var prefetchMargin: CGFloat
+
+    private var outOfRangeSince: [String: TimeInterval] = [:]
+    private(set) var pausedStreamIds: Set<String> = []
+
+    init(gracePeriod: TimeInterval = 3, prefetchMargin: CGFloat = 0) {
+        self.gracePeriod = gracePeriod
+        self.prefetchMargin = prefetchMargin
+    }
+
+    func isPaused(_ streamId: String) -> Bool {
+        return pausedStreamIds.contains(streamId)
+    }
+
+    /// Evaluates `tiles`, frames in the same coordinates as `visibleBounds`, at monotonic time
+    /// `now`. Returns the streams whose video should change: true to resume, false to pause.
+    func update(tiles: [String: CGRect], visibleBounds: CGRect, now: TimeInterval) -> [String: Bool] {
+        let range = visibleBounds.insetBy(dx: -prefetchMargin, dy: -prefetchMargin)
+        var changes: [String: Bool] = [:]
+
+        for (streamId, frame) in tiles {
+            if frame.intersects(range) {
+                outOfRangeSince.removeValue(forKey: streamId)
+                if pausedStreamIds.remove(streamId) != nil {
+                    changes[streamId] = true
+                }
+                continue
+            }
+
+            guard !pausedStreamIds.contains(streamId) else { continue }
+            let since = outOfRangeSince[streamId] ?? now
+            outOfRangeSince[streamId] = since
+            if now - since >= gracePeriod {
+                outOfRangeSince.removeValue(forKey: streamId)
+                pausedStreamIds.insert(streamId)
+                changes[streamId] = false
+            }
+        }
+        return changes
+    }
+
+    /// Treats `streamId` as paused, for subscribers that start without video. Its video
+    /// resumes on the next update that finds it in range.
+    func markPaused(_ streamId: String) {
+        outOfRangeSince.removeValue(forKey: streamId)
+        pausedStreamIds.insert(streamId)
+    }
+
+    func remove(streamId: String) {
+        outOfRangeSince.removeValue(forKey: streamId)
+        pausedStreamIds.remove(streamId)
+    }
+
+    func removeAll() {
+        outOfRangeSince.removeAll()
+        pausedStreamIds.removeAll()
+    }
+}
@@ -0,0 +1,113 @@
+//
+//  SyntheticPattern.swift
+//  Basic-Video-Chat
+//
+//  Deterministic I420 test pattern, so encoded bitrate depends on the
+//  configuration instead of whatever is in front of the camera: a diagonal
+//  luma ramp and a box that move `motion` pixels per frame, chroma bands
+//  moving against them, and per-pixel noise scaled by `entropy`. The same
+//  configuration and frame index always produce the same bytes.
+//
+//  Only Foundation is used here and frames are written into caller-owned
+//  planes, so the generator runs (and can be timed) off iOS as well.
+//
+
+import Foundation
+
+struct SyntheticPattern {
+    struct Configuration: Equatable {
+        /// 0 is a still image, 1 moves the pattern `maxSpeed` pixels per frame
+        var motion: Double = 0.5
+        /// 0 is a clean pattern, 1 adds noise of about ±96 luma levels to every pixel
+        var entropy: Double = 0.2
+        var seed: UInt32 = 1
+    }
+
+    static let maxSpeed = 16.0
+
+    let width: Int
+    let height: Int
+    let configuration: Configuration
+
+    init(width: Int, height: Int, configuration: Configuration = Configuration()) {
+        precondition(width > 0 && height > 0 && width % 2 == 0 && height % 2 == 0,
+                     "I420 needs positive, even dimensions")
+        self.width = width
+        self.height = height
+        // Frame metadata carries these as Float32, keep them exactly representable there
+        var configuration = configuration
+        configuration.motion = Double(Float(configuration.motion))
+        configuration.entropy = Double(Float(configuration.entropy))
+        self.configuration = configuration
+    }
+
+    var chromaWidth: Int { return width / 2 }
+    var chromaHeight: Int { return height / 2 }
+
+    /// Bytes of one tightly packed I420 frame
+    var frameByteCount: Int { return width * height + 2 * chromaWidth * chromaHeight }
+
+    func render(frameIndex: Int, into planes: I420Planes) {
+        let shift = self.shift(frameIndex: frameIndex)
+        renderLuma(shift: shift, frameIndex: frameIndex, into: planes.y, stride: planes.yStride)
+        renderChroma(shift: shift, u: planes.u, uStride: planes.uStride, v: planes.v, vStride: planes.vStride)
+    }
+
+    /// Renders only the luma plane, e.g. to rebuild the reference for a received frame.
+    func renderLuma(frameIndex: Int, into plane: UnsafeMutablePointer<UInt8>, stride: Int) {
+        renderLuma(shift: shift(frameIndex: frameIndex), frameIndex: frameIndex, into: plane, stride: stride)
+    }
+
+    private func shift(frameIndex: Int) -> Int {
+        return Int((Double(frameIndex) * configuration.motion * SyntheticPattern.maxSpeed).rounded())
+    }
+
+    private func renderLuma(shift: Int, frameIndex: Int, into plane: UnsafeMutablePointer<UInt8>, stride: Int) {
+        // Box of a quarter of the height sweeping left to right and wrapping around
+        let boxSize = max(2, height / 4)
+        let boxX = (shift * 2) % (width + boxSize) - boxSize
+        let boxY = (height - boxSize) / 2
+        let boxColumns = max(0, boxX) ..< min(width, boxX + boxSize)
+
+        let noiseAmplitude = Int((min(max(configuration.entropy, 0), 1) * 96).rounded())
+        let noiseRange = 2 * noiseAmplitude + 1
+        // xorshift32 reseeded per frame; the state must not be zero
+        var state = configuration.seed ^ UInt32(truncatingIfNeeded: frameIndex &* 0x9E37_79B9)
+        if state == 0 {
+            state = 0x6D2B_79F5
+        }
+
+        for row in 0 ..< height {
+            let line = plane + row * stride
+            let isBoxRow = row >= boxY && row < boxY + boxSize
+            for column in 0 ..< width {
+                // Studio-range ramp repeating every 256 pixels along the diagonal
+                var value = 16 + ((column + row + shift) & 0xFF) * 219 / 255
+                if isBoxRow && boxColumns.contains(column) {
+                    value = 235 - value / 4
+                }
+                if noiseAmplitude > 0 {
+                    state ^= state << 13
+                    state ^= state >> 17
+                    state ^= state << 5
+                    value += ((Int(state >> 24) * noiseRange) >> 8) - noiseAmplitude
+                }
+                line[column] = UInt8(clamping: value)
+            }
+        }
+    }
+
+    private func renderChroma(shift: Int,
+                              u: UnsafeMutablePointer<UInt8>, uStride: Int,
+                              v: UnsafeMutablePointer<UInt8>, vStride: Int) {
+        for row in 0 ..< chromaHeight {
+            let uLine = u + row * uStride
+            let vLine = v + row * vStride
+            let vValue = UInt8(64 + ((row * 2 + shift) & 0x7F))
+            for column in 0 ..< chromaWidth {
+                uLine[column] = UInt8(64 + ((column * 2 - shift) & 0x7F))
+                vLine[column] = vValue
+            }
+        }
+    }
+}
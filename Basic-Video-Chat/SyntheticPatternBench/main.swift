@@ -0,0 +1,65 @@
+//
+//  main.swift
+//  SyntheticPatternBench
+//
+//  Cost of rendering the synthetic test pattern at the two publish sizes,
+//  across motion and entropy settings, against the 33 ms a frame has at
+//  30 fps. Foundation only, so it builds on macOS and Linux:
+//
+//    swiftc -O Basic-Video-Chat/BenchSupport/BenchSupport.swift Basic-Video-Chat/SyntheticPattern.swift \
+//        Basic-Video-Chat/PixelFormatConversion.swift Basic-Video-Chat/SyntheticPatternBench/main.swift \
+//        -o synthetic-pattern-bench
+//    ./synthetic-pattern-bench [frames per run]
+//
+//  Next to the time it prints the mean absolute luma change between
+//  consecutive frames, a rough measure of how much the encoder has to send.
+//
+
+import Foundation
+
+let framesPerRun = Bench.argument(1, default: 30)
+
+let sizes: [(name: String, width: Int, height: Int)] = [("480p", 640, 480), ("1080p", 1920, 1080)]
+let settings: [(motion: Double, entropy: Double)] = [(0, 0), (0.5, 0.2), (1, 0), (1, 1)]
+
+for size in sizes {
+    print("\(size.name), \(framesPerRun) frames per run")
+    let lumaCount = size.width * size.height
+    let chromaCount = lumaCount / 4
+    let storage = UnsafeMutablePointer<UInt8>.allocate(capacity: lumaCount + 2 * chromaCount)
+    let previous = UnsafeMutablePointer<UInt8>.allocate(capacity: lumaCount)
+    defer {
+        storage.deallocate()
+        previous.deallocate()
+    }
+    let planes = I420Planes(y: storage, yStride: size.width,
+                            u: storage + lumaCount, uStride: size.width / 2,
+                            v: storage + lumaCount + chromaCount, vStride: size.width / 2)
+
+    for setting in settings {
+        var configuration = SyntheticPattern.Configuration()
+        configuration.motion = setting.motion
+        configuration.entropy = setting.entropy
+        let pattern = SyntheticPattern(width: size.width, height: size.height, configuration: configuration)
+
+        var frameIndex = 0
+        let time = Bench.measure {
+            for _ in 0 ..< framesPerRun {
+                pattern.render(frameIndex: frameIndex, into: planes)
+                frameIndex += 1
+            }
+        }
+
+        pattern.renderLuma(frameIndex: 0, into: previous, stride: size.width)
+        pattern.renderLuma(frameIndex: 1, into: storage, stride: size.width)
+        var change = 0
+        for i in 0 ..< lumaCount {
+            change += abs(Int(storage[i]) - Int(previous[i]))
+        }
+
+        let perFrame = (best: time.best / Double(framesPerRun), median: time.median / Double(framesPerRun))
+        Bench.report(String(format: "  motion %.1f entropy %.1f", setting.motion, setting.entropy), perFrame,
+                     extra: String(format: "per frame, %.1f%% of 33 ms, luma change %.1f",
+                                   perFrame.median / (1.0 / 30) * 100, Double(change) / Double(lumaCount)))
+    }
+}
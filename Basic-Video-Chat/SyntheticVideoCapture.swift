@@ -0,0 +1,166 @@
+//
+//  SyntheticVideoCapture.swift
+//  Basic-Video-Chat
+//
+//  OTVideoCapture that publishes a SyntheticPattern instead of the camera,
+//  for QoD comparisons that shouldn't depend on the scene. Frames are
+//  rendered on a private queue at a fixed rate into a small ring of
+//  buffers from the shared PlaneBufferPool, each wrapped by an OTVideoFrame
+//  created once, so steady-state capture allocates nothing per frame beyond
+//  the few bytes of FrameStamp metadata, and publishing again reuses the
+//  buffers of the previous run.
+//
+
+import Foundation
+import CoreMedia
+import OpenTok
+
+final class SyntheticVideoCapture: NSObject, OTVideoCapture {
+    weak var videoCaptureConsumer: OTVideoCaptureConsumer?
+    var videoContentHint: OTVideoContentHint = .motion
+
+    let frameRate: Int
+    /// Sends a FrameReference with every frame so subscribers can score it against the original
+    var stampsFrameReferences = true
+    private let pattern: SyntheticPattern
+    private let bufferPool: PlaneBufferPool
+
+    // Frames are consumed synchronously, a few slots only keep one in flight per buffer
+    private static let poolSize = 3
+
+    private let queue = DispatchQueue(label: "com.tokbox.Hello-World.syntheticCapture")
+    // Owned by `queue`
+    private var pool: [FrameSlot] = []
+    private var timer: DispatchSourceTimer?
+    private var frameIndex = 0
+
+    init(width: Int, height: Int, frameRate: Int = 30,
+         configuration: SyntheticPattern.Configuration = SyntheticPattern.Configuration()) {
+        self.pattern = SyntheticPattern(width: width, height: height, configuration: configuration)
+        self.frameRate = max(1, frameRate)
+        self.bufferPool = PlaneBufferPool.shared(for: PlaneBufferLayout(width: width, height: height, pixelFormat: .i420))
+        super.init()
+    }
+
+    deinit {
+        timer?.cancel()
+    }
+
+    // MARK: - OTVideoCapture
+
+    func initCapture() {
+        queue.sync {
+            guard pool.isEmpty else { return }
+            pool = (0 ..< SyntheticVideoCapture.poolSize).map { _ in FrameSlot(bufferPool: bufferPool, format: makeFormat()) }
+        }
+    }
+
+    func releaseCapture() {
+        queue.sync {
+            stopTimer()
+            pool.removeAll()
+        }
+        let metrics = bufferPool.metrics
+        print("Synthetic capture buffers: \(metrics.acquisitions) acquired, \(metrics.allocations) allocated, " +
+              "hit rate \(String(format: "%.2f", metrics.hitRate))")
+    }
+
+    func startCapture() -> Int32 {
+        queue.sync {
+            guard timer == nil, !pool.isEmpty else { return }
+            let timer = DispatchSource.makeTimerSource(queue: queue)
+            let interval = DispatchTimeInterval.nanoseconds(1_000_000_000 / frameRate)
+            timer.schedule(deadline: .now(), repeating: interval, leeway: .milliseconds(1))
+            timer.setEventHandler { [weak self] in
+                self?.deliverFrame()
+            }
+            timer.resume()
+            self.timer = timer
+        }
+        return 0
+    }
+
+    func stopCapture() -> Int32 {
+        queue.sync {
+            stopTimer()
+        }
+        return 0
+    }
+
+    func isCaptureStarted() -> Bool {
+        return queue.sync { timer != nil }
+    }
+
+    func captureSettings(_ videoFormat: OTVideoFormat) -> Int32 {
+        videoFormat.pixelFormat = .I420
+        videoFormat.imageWidth = UInt32(pattern.width)
+        videoFormat.imageHeight = UInt32(pattern.height)
+        videoFormat.estimatedFramesPerSecond = Double(frameRate)
+        videoFormat.estimatedCaptureDelay = 0
+        return 0
+    }
+
+    // MARK: - Frames
+
+    private func makeFormat() -> OTVideoFormat {
+        let format = OTVideoFormat.videoFormatI420(withWidth: UInt32(pattern.width), height: UInt32(pattern.height))
+        format.estimatedFramesPerSecond = Double(frameRate)
+        bufferPool.layout.applyStrides(to: format)
+        return format
+    }
+
+    private func stopTimer() {
+        timer?.cancel()
+        timer = nil
+    }
+
+    private func deliverFrame() {
+        guard let consumer = videoCaptureConsumer, !pool.isEmpty else { return }
+        let slot = pool[frameIndex % pool.count]
+        pattern.render(frameIndex: frameIndex, into: slot.planes)
+        slot.frame.timestamp = CMClockGetTime(CMClockGetHostTimeClock())
+        // Capture time for latency, plus the reference when subscribers should score the frame
+        let reference = stampsFrameReferences
+            ? FrameReference(frameIndex: frameIndex, width: pattern.width, height: pattern.height,
+                             configuration: pattern.configuration)
+            : nil
+        var error: OTError?
+        slot.frame.setMetadata(FrameStamp(captureTime: Date().timeIntervalSince1970, reference: reference).encoded(),
+                               error: &error)
+        frameIndex += 1
+        consumer.consumeFrame(slot.frame)
+    }
+}
+
+/// One frame of the ring: an I420 buffer held from the pool and the OTVideoFrame pointing into it.
+private final class FrameSlot {
+    let frame: OTVideoFrame
+    let planes: I420Planes
+    private let bufferPool: PlaneBufferPool
+    private let buffer: PlaneBuffer
+    private let planePointers: UnsafeMutablePointer<UnsafeMutablePointer<UInt8>>
+
+    /// `format` must carry the pool layout's strides.
+    init(bufferPool: PlaneBufferPool, format: OTVideoFormat) {
+        self.bufferPool = bufferPool
+        buffer = bufferPool.acquire()
+        guard let planes = buffer.i420Planes else {
+            preconditionFailure("synthetic capture needs an I420 buffer pool")
+        }
+        self.planes = planes
+
+        planePointers = UnsafeMutablePointer<UnsafeMutablePointer<UInt8>>.allocate(capacity: 3)
+        planePointers.initialize(from: [planes.y, planes.u, planes.v], count: 3)
+
+        frame = OTVideoFrame(format: format)
+        frame.orientation = .up
+        frame.setPlanesWithPointers(planePointers, numPlanes: 3)
+    }
+
+    deinit {
+        frame.clearPlanes()
+        planePointers.deinitialize(count: 3)
+        planePointers.deallocate()
+        bufferPool.release(buffer)
+    }
+}
@@ -16,58 +16,47 @@ class DateValueFormatter: AxisValueFormatter {
 
 class TestResultsViewController: UIViewController {
     private let videoResult: VideoResultSet
+    private let settleTime: TimeInterval
+    
     
     // UI Elements
     private var titleLabel: UILabel!
     
-    // Chart Views
-    private let bitrateChartTitleLabel: UILabel = {
+    // Paired baseline/QoD summary, empty unless the run was an automated A/B test
+    private let comparisonLabel: UILabel = {
         let label = UILabel()
-        label.text = "Video Bitrate (Kbps)"
-        label.font = .systemFont(ofSize: 16, weight: .medium)
+        label.font = .systemFont(ofSize: 13)
+        label.textColor = .darkGray
         label.textAlignment = .center
+        label.numberOfLines = 0
         return label
     }()
     
-    private let bitrateChartView: LineChartView = {
-        let chartView = LineChartView()
-        chartView.rightAxis.enabled = false
-        chartView.xAxis.labelPosition = .bottom
-        chartView.xAxis.labelRotationAngle = 0
-        chartView.xAxis.valueFormatter = DateValueFormatter()
-        chartView.leftAxis.labelPosition = .outsideChart
-        chartView.leftAxis.axisMinimum = 0
-        chartView.dragEnabled = true
-        chartView.pinchZoomEnabled = true
-        chartView.doubleTapToZoomEnabled = true
-        chartView.chartDescription.enabled = false  // Disable default description
-        return chartView
-    }()
+    // Chart Views
+    private let bitrateChartTitleLabel = TestResultsViewController.makeChartTitleLabel("Video Bitrate (Kbps)")
     
-    private let packetLossChartTitleLabel: UILabel = {
-        let label = UILabel()
-        label.text = "Packet Loss Ratio"
-        label.font = .systemFont(ofSize: 16, weight: .medium)
-        label.textAlignment = .center
-        return label
-    }()
+    private let bitrateChartView = TestResultsViewController.makeChartView()
     
-    private let packetLossChartView: LineChartView = {
-        let chartView = LineChartView()
-        chartView.rightAxis.enabled = false
-        chartView.xAxis.labelPosition = .bottom
-        chartView.xAxis.labelRotationAngle = 0
-        chartView.xAxis.valueFormatter = DateValueFormatter()
-        chartView.leftAxis.labelPosition = .outsideChart
-        chartView.leftAxis.axisMinimum = 0
+    private let packetLossChartTitleLabel = TestResultsViewController.makeChartTitleLabel("Packet Loss Ratio")
+    
+    private let packetLossChartView: LayeredLineChartView = {
+        let chartView = TestResultsViewController.makeChartView()
         chartView.leftAxis.axisMaximum = 1
-        chartView.dragEnabled = true
-        chartView.pinchZoomEnabled = true
-        chartView.doubleTapToZoomEnabled = true
-        chartView.chartDescription.enabled = false  // Disable default description
         return chartView
     }()
     
+    // One chart per frame-quality metric the run measured, below bitrate and packet loss
+    private var frameQualityCharts: [(metric: FrameQualityMetric, chartView: LayeredLineChartView)] = []
+    
+    // Charts and summaries scroll, the start over button stays put
+    private let scrollView = UIScrollView()
+    private let contentStack: UIStackView = {
+        let stack = UIStackView()
+        stack.axis = .vertical
+        stack.spacing = 8
+        return stack
+    }()
+    
     private lazy var startOverButton: UIButton = {
         let button = UIButton(type: .system)
         button.setTitle("Start Over", for: .normal)
@@ -78,8 +67,9 @@ class TestResultsViewController: UIViewController {
         return button
     }()
     
-    init(videoResult: VideoResultSet) {
+    init(videoResult: VideoResultSet, settleTime: TimeInterval = 0) {
         self.videoResult = videoResult
+        self.settleTime = settleTime
         super.init(nibName: nil, bundle: nil)
     }
     
@@ -91,6 +81,7 @@ class TestResultsViewController: UIViewController {
         super.viewDidLoad()
         setupUI()
         setupCharts()
+        setupComparison()
     }
     
     private func setupUI() {
@@ -101,55 +92,51 @@ class TestResultsViewController: UIViewController {
         titleLabel.text = "Test Results"
         titleLabel.textAlignment = .center
         titleLabel.font = UIFont.systemFont(ofSize: 24, weight: .medium)
-        view.addSubview(titleLabel)
         
-        // Setup charts and their titles
-        view.addSubview(bitrateChartTitleLabel)
-        view.addSubview(bitrateChartView)
-        view.addSubview(packetLossChartTitleLabel)
-        view.addSubview(packetLossChartView)
+        // Stack the summaries and every chart with its title
+        contentStack.addArrangedSubview(titleLabel)
+        contentStack.addArrangedSubview(comparisonLabel)
+        contentStack.setCustomSpacing(12, after: comparisonLabel)
+        addChart(bitrateChartView, titleLabel: bitrateChartTitleLabel)
+        addChart(packetLossChartView, titleLabel: packetLossChartTitleLabel)
+        
+        let pyramids = videoResult.frameQualityPyramids
+        for metric in FrameQualityMetric.allCases {
+            let measured = [false, true].contains { qodEnabled in
+                !pyramids[FrameQualitySeries(metric: metric, qodEnabled: qodEnabled)]!.isEmpty
+            }
+            guard measured else { continue }
+            let chartView = TestResultsViewController.makeChartView()
+            addChart(chartView, titleLabel: TestResultsViewController.makeChartTitleLabel(metric.title))
+            frameQualityCharts.append((metric, chartView))
+        }
+        
+        scrollView.addSubview(contentStack)
+        view.addSubview(scrollView)
         
         // Setup start over button
         view.addSubview(startOverButton)
         
         // Configure auto layout
-        titleLabel.translatesAutoresizingMaskIntoConstraints = false
-        bitrateChartTitleLabel.translatesAutoresizingMaskIntoConstraints = false
-        bitrateChartView.translatesAutoresizingMaskIntoConstraints = false
-        packetLossChartTitleLabel.translatesAutoresizingMaskIntoConstraints = false
-        packetLossChartView.translatesAutoresizingMaskIntoConstraints = false
+        scrollView.translatesAutoresizingMaskIntoConstraints = false
+        contentStack.translatesAutoresizingMaskIntoConstraints = false
         startOverButton.translatesAutoresizingMaskIntoConstraints = false
         
         NSLayoutConstraint.activate([
-            // Title constraints
-            titleLabel.topAnchor.constraint(equalTo: view.safeAreaLayoutGuide.topAnchor, constant: 20),
-            titleLabel.leadingAnchor.constraint(equalTo: view.leadingAnchor, constant: 20),
-            titleLabel.trailingAnchor.constraint(equalTo: view.trailingAnchor, constant: -20),
-            
-            // Bitrate chart title constraints
-            bitrateChartTitleLabel.topAnchor.constraint(equalTo: titleLabel.bottomAnchor, constant: 20),
-            bitrateChartTitleLabel.leadingAnchor.constraint(equalTo: view.leadingAnchor, constant: 20),
-            bitrateChartTitleLabel.trailingAnchor.constraint(equalTo: view.trailingAnchor, constant: -20),
-            
-            // Bitrate chart constraints
-            bitrateChartView.topAnchor.constraint(equalTo: bitrateChartTitleLabel.bottomAnchor, constant: 8),
-            bitrateChartView.leadingAnchor.constraint(equalTo: view.leadingAnchor, constant: 20),
-            bitrateChartView.trailingAnchor.constraint(equalTo: view.trailingAnchor, constant: -20),
-            bitrateChartView.heightAnchor.constraint(equalToConstant: 200),
-            
-            // Packet loss chart title constraints
-            packetLossChartTitleLabel.topAnchor.constraint(equalTo: bitrateChartView.bottomAnchor, constant: 20),
-            packetLossChartTitleLabel.leadingAnchor.constraint(equalTo: view.leadingAnchor, constant: 20),
-            packetLossChartTitleLabel.trailingAnchor.constraint(equalTo: view.trailingAnchor, constant: -20),
+            // Scroll view constraints
+            scrollView.topAnchor.constraint(equalTo: view.safeAreaLayoutGuide.topAnchor),
+            scrollView.leadingAnchor.constraint(equalTo: view.leadingAnchor),
+            scrollView.trailingAnchor.constraint(equalTo: view.trailingAnchor),
+            scrollView.bottomAnchor.constraint(equalTo: startOverButton.topAnchor, constant: -12),
             
-            // Packet loss chart constraints
-            packetLossChartView.topAnchor.constraint(equalTo: packetLossChartTitleLabel.bottomAnchor, constant: 8),
-            packetLossChartView.leadingAnchor.constraint(equalTo: view.leadingAnchor, constant: 20),
-            packetLossChartView.trailingAnchor.constraint(equalTo: view.trailingAnchor, constant: -20),
-            packetLossChartView.heightAnchor.constraint(equalToConstant: 200),
+            // Content constraints, scrolling vertically only
+            contentStack.topAnchor.constraint(equalTo: scrollView.contentLayoutGuide.topAnchor, constant: 20),
+            contentStack.leadingAnchor.constraint(equalTo: scrollView.contentLayoutGuide.leadingAnchor, constant: 20),
+            contentStack.trailingAnchor.constraint(equalTo: scrollView.contentLayoutGuide.trailingAnchor, constant: -20),
+            contentStack.bottomAnchor.constraint(equalTo: scrollView.contentLayoutGuide.bottomAnchor),
+            contentStack.widthAnchor.constraint(equalTo: scrollView.frameLayoutGuide.widthAnchor, constant: -40),
             
             // Start over button constraints
-            startOverButton.topAnchor.constraint(equalTo: packetLossChartView.bottomAnchor, constant: 20),
             startOverButton.leadingAnchor.constraint(equalTo: view.leadingAnchor, constant: 20),
             startOverButton.trailingAnchor.constraint(equalTo: view.trailingAnchor, constant: -20),
             startOverButton.bottomAnchor.constraint(equalTo: view.safeAreaLayoutGuide.bottomAnchor, constant: -20),
@@ -157,81 +144,176 @@ class TestResultsViewController: UIViewController {
         ])
     }
     
+    private func addChart(_ chartView: LayeredLineChartView, titleLabel: UILabel) {
+        contentStack.addArrangedSubview(titleLabel)
+        contentStack.addArrangedSubview(chartView)
+        contentStack.setCustomSpacing(20, after: chartView)
+        chartView.heightAnchor.constraint(equalToConstant: 200).isActive = true
+    }
+    
+    private static func makeChartTitleLabel(_ text: String) -> UILabel {
+        let label = UILabel()
+        label.text = text
+        label.font = .systemFont(ofSize: 16, weight: .medium)
+        label.textAlignment = .center
+        return label
+    }
+    
+    private static func makeChartView() -> LayeredLineChartView {
+        let chartView = LayeredLineChartView()
+        chartView.rightAxis.enabled = false
+        chartView.xAxis.labelPosition = .bottom
+        chartView.xAxis.labelRotationAngle = 0
+        chartView.xAxis.valueFormatter = DateValueFormatter()
+        chartView.leftAxis.labelPosition = .outsideChart
+        chartView.leftAxis.axisMinimum = 0
+        chartView.dragEnabled = true
+        chartView.pinchZoomEnabled = true
+        chartView.doubleTapToZoomEnabled = true
+        chartView.chartDescription.enabled = false  // Disable default description
+        return chartView
+    }
+    
     @objc private func startOverTapped() {
         // Pop to root view controller (HomeViewController)
         navigationController?.popToRootViewController(animated: true)
     }
     
-    private func setupCharts() {
-        // Print QoD status for each data point
-        print("\nTest Results with QoD Status:")
-        videoResult.qualityStats.forEach { stat in
-            print("Time: \(Date(timeIntervalSince1970: stat.timestamp / 1000)), " +
-                  "Bitrate: \(String(format: "%.1f", stat.videoBitrateKbps)) Kbps, " +
-                  "Packet Loss: \(String(format: "%.3f", stat.packetLossRatio)), " +
-                  "QoD Enabled: \(stat.qodEnabled)")
-        }
+    private func setupComparison() {
+        guard !videoResult.windows.isEmpty else { return }
         
-        // Setup bitrate chart data - separate QoD enabled and disabled points
-        let bitrateEntriesQoDEnabled = videoResult.qualityStats.enumerated().compactMap { (index, stat) -> ChartDataEntry? in
-            return stat.qodEnabled ? ChartDataEntry(x: stat.timestamp / 1000, y: stat.videoBitrateKbps) : nil
-        }
+        let comparisons = PairedComparison.compare(videoResult, settleTime: settleTime)
+        comparisonLabel.text = comparisons.map { $0.summary }.joined(separator: "\n")
         
-        let bitrateEntriesQoDDisabled = videoResult.qualityStats.enumerated().compactMap { (index, stat) -> ChartDataEntry? in
-            return !stat.qodEnabled ? ChartDataEntry(x: stat.timestamp / 1000, y: stat.videoBitrateKbps) : nil
+        print("\nA/B comparison (QoD - baseline):")
+        comparisons.forEach { comparison in
+            print(comparison.summary)
+            comparison.pairs.forEach { pair in
+                print("  Pair \(pair.iteration + 1): baseline \(String(format: "%.3f", pair.baseline)), " +
+                      "QoD \(String(format: "%.3f", pair.qod))")
+            }
         }
         
-        let bitrateDataSetQoDEnabled = LineChartDataSet(entries: bitrateEntriesQoDEnabled, label: "QoD On")
-        bitrateDataSetQoDEnabled.drawCirclesEnabled = false
-        bitrateDataSetQoDEnabled.mode = .linear
-        bitrateDataSetQoDEnabled.lineWidth = 2
-        bitrateDataSetQoDEnabled.setColor(.systemRed)
-        bitrateDataSetQoDEnabled.fillAlpha = 0.3
-        bitrateDataSetQoDEnabled.drawFilledEnabled = true
-        bitrateDataSetQoDEnabled.drawValuesEnabled = false
-        
-        let bitrateDataSetQoDDisabled = LineChartDataSet(entries: bitrateEntriesQoDDisabled, label: "QoD Off")
-        bitrateDataSetQoDDisabled.drawCirclesEnabled = false
-        bitrateDataSetQoDDisabled.mode = .linear
-        bitrateDataSetQoDDisabled.lineWidth = 2
-        bitrateDataSetQoDDisabled.setColor(.systemBlue)
-        bitrateDataSetQoDDisabled.fillAlpha = 0.3
-        bitrateDataSetQoDDisabled.drawFilledEnabled = true
-        bitrateDataSetQoDDisabled.drawValuesEnabled = false
+        // Mark each window's start on the bitrate chart
+        videoResult.windows.forEach { window in
+            let limitLine = ChartLimitLine(limit: window.startTimestamp / 1000, label: window.label)
+            limitLine.lineWidth = 1
+            limitLine.lineDashLengths = [4, 4]
+            limitLine.lineColor = window.kind == .qod ? .systemRed : .systemGray
+            limitLine.valueFont = .systemFont(ofSize: 9)
+            bitrateChartView.xAxis.addLimitLine(limitLine)
+        }
+    }
+    
+    private func setupCharts() {
+        // Print QoD status for each data point
+        SampleLog.print("\nTest Results with QoD Status:")
+        if SampleLog.isEnabled {
+            videoResult.qualityStats.forEach { stat in
+                SampleLog.print("Time: \(Date(timeIntervalSince1970: stat.timestamp / 1000)), " +
+                                "Bitrate: \(String(format: "%.1f", stat.videoBitrateKbps)) Kbps, " +
+                                "Packet Loss: \(String(format: "%.3f", stat.packetLossRatio)), " +
+                                "QoD Enabled: \(stat.qodEnabled)")
+            }
+        }
         
-        let bitrateData = LineChartData(dataSets: [bitrateDataSetQoDDisabled, bitrateDataSetQoDEnabled])
-        bitrateChartView.data = bitrateData
-        bitrateChartView.animate(xAxisDuration: 1.0)
+        // Series were split by QoD state while the test ran; the charts only pull the visible window
+        setData(bitrateChartView, dataSets: bitrateSeriesStyles.map {
+            makeDataSet(source: videoResult.seriesView($0.series), label: $0.label, color: $0.color)
+        })
+        setData(packetLossChartView, dataSets: packetLossSeriesStyles.map {
+            makeDataSet(source: videoResult.seriesView($0.series), label: $0.label, color: $0.color)
+        })
         
-        // Setup packet loss chart data - separate QoD enabled and disabled points
-        let packetLossEntriesQoDEnabled = videoResult.qualityStats.enumerated().compactMap { (index, stat) -> ChartDataEntry? in
-            return stat.qodEnabled ? ChartDataEntry(x: stat.timestamp / 1000, y: stat.packetLossRatio) : nil
+        // Frame-quality series are read from their pyramids, one tick per point
+        let pyramids = videoResult.frameQualityPyramids
+        for (metric, chartView) in frameQualityCharts {
+            setData(chartView, dataSets: [false, true].map { qodEnabled in
+                makeDataSet(source: pyramids[FrameQualitySeries(metric: metric, qodEnabled: qodEnabled)]!,
+                            label: qodEnabled ? "QoD On" : "QoD Off",
+                            color: qodEnabled ? .systemRed : .systemBlue)
+            })
         }
         
-        let packetLossEntriesQoDDisabled = videoResult.qualityStats.enumerated().compactMap { (index, stat) -> ChartDataEntry? in
-            return !stat.qodEnabled ? ChartDataEntry(x: stat.timestamp / 1000, y: stat.packetLossRatio) : nil
+        // Bounds aren't known until layout, so decimate for the initial viewport once it is
+        view.layoutIfNeeded()
+        let chartViews = [bitrateChartView, packetLossChartView] + frameQualityCharts.map { $0.chartView }
+        chartViews.forEach { chartView in
+            chartView.notifyDataSetChanged()
+            reloadVisibleEntries(chartView)
+            
+            // Uncover the prerendered data instead of redrawing it at every animation phase
+            chartView.animateReveal(duration: 1.0)
         }
+    }
+    
+    private func setData(_ chartView: LayeredLineChartView, dataSets: [StreamingLineChartDataSet]) {
+        chartView.renderer = ContiguousLineChartRenderer(chartView: chartView)
+        chartView.data = LineChartData(dataSets: dataSets)
+        chartView.delegate = self
+    }
+    
+    // MARK: - Level of detail
+    
+    private struct SeriesStyle {
+        let series: ChartSeries
+        let label: String
+        let color: UIColor
+    }
+    
+    private let bitrateSeriesStyles = [
+        SeriesStyle(series: .bitrateQoDOff, label: "QoD Off", color: .systemBlue),
+        SeriesStyle(series: .bitrateQoDOn, label: "QoD On", color: .systemRed)
+    ]
+    
+    private let packetLossSeriesStyles = [
+        SeriesStyle(series: .packetLossQoDOff, label: "QoD Off", color: .systemOrange),
+        SeriesStyle(series: .packetLossQoDOn, label: "QoD On", color: .systemGreen)
+    ]
+    
+    private func makeDataSet(source: ChartSeriesSource, label: String, color: UIColor) -> StreamingLineChartDataSet {
+        // Reads the recorded samples in place, the data set only holds the visible window
+        let dataSet = StreamingLineChartDataSet(source: source, label: label)
+        dataSet.drawCirclesEnabled = false
+        dataSet.mode = .linear
+        dataSet.lineWidth = 2
+        dataSet.setColor(color)
+        dataSet.fillAlpha = 0.3
+        dataSet.drawFilledEnabled = true
+        dataSet.drawValuesEnabled = false
+        dataSet.isLookupTableEnabled = true
+        return dataSet
+    }
+    
+    /// Reloads every data set whose loaded window no longer suits the viewport.
+    /// Gap markers between QoD transitions are kept, the renderer lifts the pen at them.
+    private func reloadVisibleEntries(_ chartView: LineChartView) {
+        guard chartView.viewPortHandler.contentWidth > 0,
+              let dataSets = chartView.data?.dataSets else { return }
         
-        let packetLossDataSetQoDEnabled = LineChartDataSet(entries: packetLossEntriesQoDEnabled, label: "QoD On")
-        packetLossDataSetQoDEnabled.drawCirclesEnabled = false
-        packetLossDataSetQoDEnabled.mode = .linear
-        packetLossDataSetQoDEnabled.lineWidth = 2
-        packetLossDataSetQoDEnabled.setColor(.systemGreen)
-        packetLossDataSetQoDEnabled.fillAlpha = 0.3
-        packetLossDataSetQoDEnabled.drawFilledEnabled = true
-        packetLossDataSetQoDEnabled.drawValuesEnabled = false
-        
-        let packetLossDataSetQoDDisabled = LineChartDataSet(entries: packetLossEntriesQoDDisabled, label: "QoD Off")
-        packetLossDataSetQoDDisabled.drawCirclesEnabled = false
-        packetLossDataSetQoDDisabled.mode = .linear
-        packetLossDataSetQoDDisabled.lineWidth = 2
-        packetLossDataSetQoDDisabled.setColor(.systemOrange)
-        packetLossDataSetQoDDisabled.fillAlpha = 0.3
-        packetLossDataSetQoDDisabled.drawFilledEnabled = true
-        packetLossDataSetQoDDisabled.drawValuesEnabled = false
+        let pixelWidth = Double(chartView.viewPortHandler.contentWidth * chartView.contentScaleFactor)
+        var didReload = false
+        for case let dataSet as StreamingLineChartDataSet in dataSets {
+            didReload = dataSet.loadVisibleRange(fromX: chartView.lowestVisibleX,
+                                                 toX: chartView.highestVisibleX,
+                                                 pixelWidth: pixelWidth) || didReload
+        }
         
-        let packetLossData = LineChartData(dataSets: [packetLossDataSetQoDDisabled, packetLossDataSetQoDEnabled])
-        packetLossChartView.data = packetLossData
-        packetLossChartView.animate(xAxisDuration: 1.0)
+        guard didReload else { return }
+        chartView.data?.notifyDataChanged()
+        chartView.notifyDataSetChanged()
+    }
+}
+
+// MARK: - ChartViewDelegate
+extension TestResultsViewController: ChartViewDelegate {
+    func chartScaled(_ chartView: ChartViewBase, scaleX: CGFloat, scaleY: CGFloat) {
+        guard let lineChartView = chartView as? LineChartView else { return }
+        reloadVisibleEntries(lineChartView)
+    }
+    
+    func chartTranslated(_ chartView: ChartViewBase, dX: CGFloat, dY: CGFloat) {
+        guard let lineChartView = chartView as? LineChartView else { return }
+        reloadVisibleEntries(lineChartView)
     }
 }
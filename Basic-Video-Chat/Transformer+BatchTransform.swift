@@ -0,0 +1,88 @@
+//
+//  Transformer+BatchTransform.swift
+//  Basic-Video-Chat
+//
+//  Maps a whole range of contiguous x/y values to pixels in one call,
+//  instead of one CGPoint.applying(_:) per point like pointValuesToPixel.
+//  Uses vDSP where Accelerate is available and SIMD2 vectors elsewhere.
+//
+
+import Foundation
+import CoreGraphics
+import DGCharts
+#if canImport(Accelerate)
+import Accelerate
+#endif
+
+extension Transformer {
+    /// Writes the pixel position of `(xValues[i], yValues[i] * phaseY)` for every logical index
+    /// `i` in `range` into `points`, which is resized to `range.count`. NaN values stay NaN.
+    func pixelPoints(xValues: ArraySlice<Double>,
+                     yValues: ArraySlice<Double>,
+                     range: Range<Int>,
+                     phaseY: Double,
+                     into points: inout [CGPoint]) {
+        let matrix = valueToPixelMatrix
+        if points.count != range.count {
+            points = [CGPoint](repeating: .zero, count: range.count)
+        }
+
+        xValues.withUnsafeBufferPointer { xs in
+            yValues.withUnsafeBufferPointer { ys in
+                points.withUnsafeMutableBufferPointer { out in
+                    Transformer.transform(xs: UnsafeBufferPointer(rebasing: xs[range]),
+                                          ys: UnsafeBufferPointer(rebasing: ys[range]),
+                                          phaseY: phaseY,
+                                          matrix: matrix,
+                                          into: out)
+                }
+            }
+        }
+    }
+
+    /// Batch affine transform kernel: `out[i] = (xs[i], ys[i] * phaseY) * matrix`.
+    static func transform(xs: UnsafeBufferPointer<Double>,
+                          ys: UnsafeBufferPointer<Double>,
+                          phaseY: Double,
+                          matrix: CGAffineTransform,
+                          into out: UnsafeMutableBufferPointer<CGPoint>) {
+        let count = min(xs.count, ys.count, out.count)
+        guard count > 0, let xBase = xs.baseAddress, let yBase = ys.baseAddress,
+              let outBase = out.baseAddress else { return }
+
+        let a = Double(matrix.a), b = Double(matrix.b)
+        let c = Double(matrix.c) * phaseY, d = Double(matrix.d) * phaseY
+        let tx = Double(matrix.tx), ty = Double(matrix.ty)
+
+        #if canImport(Accelerate)
+        if MemoryLayout<CGFloat>.size == MemoryLayout<Double>.size {
+            // Treat the CGPoint buffer as interleaved x, y doubles and write each plane with stride 2
+            outBase.withMemoryRebound(to: Double.self, capacity: count * 2) { outX in
+                let outY = outX + 1
+                let n = vDSP_Length(count)
+                var a = a, b = b, c = c, d = d, tx = tx, ty = ty
+
+                vDSP_vsmsaD(xBase, 1, &a, &tx, outX, 2, n)
+                if c != 0 {
+                    vDSP_vsmaD(yBase, 1, &c, outX, 2, outX, 2, n)
+                }
+
+                vDSP_vsmsaD(yBase, 1, &d, &ty, outY, 2, n)
+                if b != 0 {
+                    vDSP_vsmaD(xBase, 1, &b, outY, 2, outY, 2, n)
+                }
+            }
+            return
+        }
+        #endif
+
+        // Portable path: both output coordinates of a point in one vector operation
+        let scaleX = SIMD2<Double>(a, b)
+        let scaleY = SIMD2<Double>(c, d)
+        let translation = SIMD2<Double>(tx, ty)
+        for i in 0 ..< count {
+            let p = scaleX * xBase[i] + scaleY * yBase[i] + translation
+            outBase[i] = CGPoint(x: p[0], y: p[1])
+        }
+    }
+}
@@ -7,12 +7,195 @@ struct VideoStats {
     let qodEnabled: Bool
 }
 
+/// Subscribers receiving video on one stats tick and the video bitrate they brought in,
+/// so the effect of pausing off-screen tiles can be read next to the quality stats.
+/// Timestamps are in milliseconds, on the same clock as `VideoStats.timestamp`.
+struct SubscriberVideoSample {
+    let timestamp: TimeInterval
+    let receivingCount: Int
+    let subscriberCount: Int
+    let inboundKbps: Double
+    let qodEnabled: Bool
+}
+
+/// A labelled slice of an automated A/B run. Timestamps are in milliseconds,
+/// on the same clock as `VideoStats.timestamp`.
+struct TestWindow {
+    enum Kind {
+        case baseline
+        case qod
+    }
+    
+    let kind: Kind
+    let iteration: Int
+    let startTimestamp: TimeInterval
+    var endTimestamp: TimeInterval
+    
+    var label: String {
+        switch kind {
+        case .baseline: return "Baseline \(iteration + 1)"
+        case .qod: return "QoD \(iteration + 1)"
+        }
+    }
+}
+
+/// The four line series drawn on the results screen.
+enum ChartSeries: CaseIterable {
+    case bitrateQoDOff
+    case bitrateQoDOn
+    case packetLossQoDOff
+    case packetLossQoDOn
+    
+    static func bitrate(qodEnabled: Bool) -> ChartSeries {
+        return qodEnabled ? .bitrateQoDOn : .bitrateQoDOff
+    }
+    
+    static func packetLoss(qodEnabled: Bool) -> ChartSeries {
+        return qodEnabled ? .packetLossQoDOn : .packetLossQoDOff
+    }
+    
+    /// QoD state of the samples this series draws
+    var qodEnabled: Bool {
+        switch self {
+        case .bitrateQoDOn, .packetLossQoDOn: return true
+        case .bitrateQoDOff, .packetLossQoDOff: return false
+        }
+    }
+    
+    /// The value this series plots for a sample
+    func value(of stats: VideoStats) -> Double {
+        switch self {
+        case .bitrateQoDOff, .bitrateQoDOn: return stats.videoBitrateKbps
+        case .packetLossQoDOff, .packetLossQoDOn: return stats.packetLossRatio
+        }
+    }
+}
+
+/// Frame-level metrics charted on the results screen and compared in A/B runs.
+enum FrameQualityMetric: CaseIterable {
+    case frameRate
+    case intervalJitter
+    case freezes
+    case blockiness
+    case psnr
+    case ssim
+    case latency
+    case maxLatency
+    
+    /// How the subscribers of one tick combine into the charted value
+    enum Aggregation {
+        case mean
+        case sum
+        case max
+    }
+    
+    var title: String {
+        switch self {
+        case .frameRate: return "Frame Rate (fps)"
+        case .intervalJitter: return "Frame Interval Jitter (ms)"
+        case .freezes: return "Freezes"
+        case .blockiness: return "Blockiness"
+        case .psnr: return "PSNR (dB)"
+        case .ssim: return "SSIM"
+        case .latency: return "Latency (ms)"
+        case .maxLatency: return "Max Latency (ms)"
+        }
+    }
+    
+    /// The value of one subscriber's window, nil when the window didn't measure it
+    func value(of stats: FrameQualityStats) -> Double? {
+        switch self {
+        case .frameRate: return stats.frameRate
+        case .intervalJitter: return stats.frameCount > 1 ? stats.intervalJitterMs : nil
+        case .freezes: return Double(stats.freezeCount)
+        case .blockiness: return stats.frameCount > 0 ? stats.blockiness : nil
+        // Only synthetic-pattern streams have a reference to score against
+        case .psnr: return stats.psnr
+        case .ssim: return stats.ssim
+        // Stamped frames only, once the publisher's clock offset is known
+        case .latency: return stats.latencyMs
+        case .maxLatency: return stats.maxLatencyMs
+        }
+    }
+    
+    /// Freezes add up, the worst latency is the highest one, everything else is averaged
+    var aggregation: Aggregation {
+        switch self {
+        case .freezes: return .sum
+        case .maxLatency: return .max
+        default: return .mean
+        }
+    }
+}
+
+/// One frame-quality metric with QoD on or off, drawn as its own line like `ChartSeries`.
+struct FrameQualitySeries: Hashable {
+    let metric: FrameQualityMetric
+    let qodEnabled: Bool
+}
+
+/// The frame-quality windows of every analyzed subscriber, closed on the same stats tick.
+struct FrameQualityTick {
+    let timestamp: TimeInterval
+    let qodEnabled: Bool
+    let streams: [FrameQualityStats]
+    
+    /// `metric` over the subscribers that measured it, nil when none did
+    func value(of metric: FrameQualityMetric) -> Double? {
+        let values = streams.compactMap { metric.value(of: $0) }
+        guard !values.isEmpty else { return nil }
+        switch metric.aggregation {
+        case .mean: return values.reduce(0, +) / Double(values.count)
+        case .sum: return values.reduce(0, +)
+        case .max: return values.max()
+        }
+    }
+}
+
 class VideoResultSet {
     var testName: String
-    var qualityStats: [VideoStats]
+    private(set) var qualityStats: [VideoStats]
+    // Frame-level quality per stats tick, see FrameQualityAnalyzer
+    private(set) var frameQualityTicks: [FrameQualityTick] = []
+    private(set) var subscriberVideoSamples: [SubscriberVideoSample] = []
+    var windows: [TestWindow]
+    
+    // Chart series, built as samples arrive so results open without another pass
+    private let series = ChartSeriesBuilder()
+    private let frameQualitySeries = FrameQualitySeriesBuilder()
     
     init(testName: String) {
         self.testName = testName
         self.qualityStats = []
+        self.windows = []
+    }
+    
+    /// Level-of-detail summaries per chart series, x in seconds.
+    var pyramids: [ChartSeries: SeriesPyramid] {
+        return series.pyramids
+    }
+    
+    /// Level-of-detail summaries per frame-quality series, x in seconds.
+    var frameQualityPyramids: [FrameQualitySeries: SeriesPyramid] {
+        return frameQualitySeries.pyramids
+    }
+    
+    /// Chart source reading `series` straight from `qualityStats`.
+    func seriesView(_ series: ChartSeries) -> SampleSeriesView {
+        return SampleSeriesView(results: self, series: series, summary: pyramids[series]!)
+    }
+    
+    func append(_ stats: VideoStats) {
+        qualityStats.append(stats)
+        series.append(stats)
+    }
+    
+    func append(_ tick: FrameQualityTick) {
+        frameQualityTicks.append(tick)
+        frameQualitySeries.append(tick)
+    }
+    
+    func append(_ sample: SubscriberVideoSample) {
+        subscriberVideoSamples.append(sample)
     }
 }
@@ -0,0 +1,65 @@
+//
+//  XLookupTable.swift
+//  Basic-Video-Chat
+//
+//  Bucket table over a sorted x buffer that narrows a lower-bound search to
+//  a few candidates. The covered x range is split into one bucket per point,
+//  so for evenly spaced samples (our stats arrive every 500 ms) a lookup
+//  touches O(1) entries. Uneven spacing only makes buckets fuller, never
+//  wrong. Points appended after the last rebuild aren't covered; callers
+//  search those directly.
+//
+
+import Foundation
+
+struct XLookupTable {
+    /// Indices `0 ..< coveredCount` of the buffer the table was built from
+    private(set) var coveredCount = 0
+    private var xMin = 0.0
+    private var xMax = 0.0
+    private var bucketWidth = 0.0
+    // firstIndex[b] is the first index whose x is >= xMin + b * bucketWidth
+    private var firstIndex: [Int] = []
+
+    mutating func rebuild<C: RandomAccessCollection>(_ xValues: C) where C.Element == Double, C.Index == Int {
+        invalidate()
+        guard xValues.count >= 2,
+              let first = xValues.first, let last = xValues.last,
+              last > first, first.isFinite, last.isFinite else { return }
+
+        let bucketCount = xValues.count
+        xMin = first
+        xMax = last
+        bucketWidth = (last - first) / Double(bucketCount)
+        firstIndex.reserveCapacity(bucketCount + 1)
+
+        var index = xValues.startIndex
+        for bucket in 0 ... bucketCount {
+            let edge = xMin + Double(bucket) * bucketWidth
+            while index < xValues.endIndex && xValues[index] < edge {
+                index += 1
+            }
+            firstIndex.append(index)
+        }
+        coveredCount = xValues.count
+    }
+
+    mutating func invalidate() {
+        coveredCount = 0
+        firstIndex.removeAll(keepingCapacity: true)
+    }
+
+    /// Indices that contain the lower bound of `value` (the first x >= `value`), or nil when
+    /// `value` lies past the covered range and the lower bound is at or after `coveredCount`.
+    func candidates(for value: Double) -> Range<Int>? {
+        guard coveredCount > 0, value <= xMax else { return nil }
+        guard value > xMin else { return 0 ..< 1 }
+
+        // One extra bucket on each side absorbs rounding in the bucket computation
+        let bucketCount = firstIndex.count - 1
+        let bucket = Int((value - xMin) / bucketWidth)
+        let lower = firstIndex[max(0, min(bucket - 1, bucketCount))]
+        let upper = firstIndex[max(0, min(bucket + 2, bucketCount))]
+        return lower ..< min(upper + 1, coveredCount)
+    }
+}